@@ -106,14 +106,14 @@ Complex Complex::quotient (const Complex z1, const Complex z2)
 
 Complex Complex::reciprocal () const
 {
-	return Complex::realProduct(Complex::conj(), 1 / Complex::norm());
+	return Complex::realProduct(Complex::conj(), 1 / ((Complex::real * Complex::real) + (Complex::imag * Complex::imag)));  // conj(z) / |z|^2
 }
 
 // Supplementary methods
 
 double Complex::intPow (double x, int n) //(Private) Optimized, should be a bit faster than std::pow(double, int)
 {
-	if (n <= 0) return (n == 0) ? 1 : (1 / Complex::intPow(x, n));
+	if (n <= 0) return (n == 0) ? 1 : (1 / Complex::intPow(x, -n));
 	double y = x;
 	for (int i = n-1; i--;) {
 		y *= x;
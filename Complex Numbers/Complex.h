@@ -41,17 +41,17 @@ class Complex
 		Complex operator * (const Complex& z) const { return product(getSelf(), z); }
 		Complex operator * (const double k) const { return realProduct(getSelf(), k); }  // real
 		Complex operator / (const Complex& z) const { return quotient(getSelf(), z); }
-		Complex operator / (const double k) const { return quotient(getSelf(), 1/k); }  // real
+		Complex operator / (const double k) const { return realProduct(getSelf(), 1/k); }  // real
 		Complex& operator += (const Complex& z) { return add(z); }
 		Complex& operator -= (const Complex& z) { return subtract(z); }
 		Complex& operator *= (const Complex& z) { return multiply(z); }
 		Complex& operator *= (const double k) { setValue(k * real, k * imag); return *this; }
 		Complex& operator /= (const Complex& z) { return divide(z); }
 		Complex& operator /= (const double k) { setValue(real / k, imag / k); return *this; }
-		Complex operator - () { return Complex(-real, -imag); }
-		Complex operator ~ () { return conj(); }
+		Complex operator - () const { return Complex(-real, -imag); }
+		Complex operator ~ () const { return conj(); }
 
 		static const Complex i;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,164 @@
+#ifndef FIXEDPOLYNOMIAL_H
+#define FIXEDPOLYNOMIAL_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+#include "Polynomial.h"
+
+// A polynomial of degree at most N with its coefficients inline, for the small cases (splines, filters, approximations)
+// where a heap vector costs more than the arithmetic. Everything is constexpr, and the hot loops run over compile-time
+// bounds and are marked for unrolling (GCC does not unroll them at -O2 otherwise): evaluate() on a
+// FixedPolynomial<double, 8> is 8 multiply-adds and no allocation.
+// It is an expression of its own (see PolynomialExpr.h), so Polynomial p = f, p += f and p - f * 2 all work; sums and
+// products of two FixedPolynomials stay fixed. (Coefficients live in a plain array: a std::array cannot be written in a
+// C++14 constant expression, so it only appears in the interface.)
+
+template<typename T, std::size_t N>
+class FixedPolynomial : public PolyExpr<FixedPolynomial<T, N> >
+{
+	private:
+		T c[N + 1];  // Highest term first, as in Polynomial: c[0] is the coefficient of x^N
+
+		template<typename U, std::size_t M> friend class FixedPolynomial;
+		template<std::size_t... I> constexpr std::array<T, N + 1> toArray (std::index_sequence<I...>) const { return {{ c[I]... }}; }
+		template<std::size_t M, int Sign> constexpr FixedPolynomial<T, (N > M ? N : M)> sum (const FixedPolynomial<T, M>& poly) const;
+
+	public:
+		constexpr FixedPolynomial () : c{} { c[N] = 1; }  // No specification results in a unit polynomial, as in Polynomial
+		constexpr FixedPolynomial (std::initializer_list<T> coef);  // Highest term first; fewer than N + 1 fill the low terms
+		constexpr FixedPolynomial (const std::array<T, N + 1>& coef);
+		explicit FixedPolynomial (const Polynomial& poly);  // Degree at most N
+		constexpr std::array<T, N + 1> getCoefficients () const { return toArray(std::make_index_sequence<N + 1>()); }
+		constexpr int getDegree () const;  // Of the highest non-zero term
+
+		// Expression protocol (see PolynomialExpr.h)
+		constexpr std::size_t size () const { return N + 1; }
+		constexpr T coefficient (const std::size_t k) const { return k <= N ? c[N - k] : T (0); }  // Of x^k
+		constexpr bool aliases (const Polynomial*) const { return false; }
+
+		// Calculations
+		constexpr T evaluate (const T x) const;  // Horner's rule
+		constexpr T derivativeEval (const T x) const;  // Horner on p and p' together
+		constexpr FixedPolynomial<T, (N > 0 ? N - 1 : 0)> derivativePoly () const;
+
+		// Operators (with a Polynomial, +, - and scalar * build expressions instead, see PolynomialExpr.h)
+		template<std::size_t M> constexpr bool operator == ( const FixedPolynomial<T, M>& poly ) const;  // Binary Comparison (==)
+		template<std::size_t M> constexpr bool operator != ( const FixedPolynomial<T, M>& poly ) const { return !(*this == poly); }  // Binary Comparison (!=)
+		template<std::size_t M> constexpr FixedPolynomial<T, (N > M ? N : M)> operator + ( const FixedPolynomial<T, M>& poly ) const { return sum<M, 1>(poly); }  // Binary (+)
+		template<std::size_t M> constexpr FixedPolynomial<T, (N > M ? N : M)> operator - ( const FixedPolynomial<T, M>& poly ) const { return sum<M, -1>(poly); }  // Binary (-)
+		template<std::size_t M> constexpr FixedPolynomial<T, N + M> operator * ( const FixedPolynomial<T, M>& poly ) const;  // Binary (*)
+		template<typename K, typename = typename std::enable_if<std::is_arithmetic<K>::value>::type>
+		constexpr FixedPolynomial operator * ( const K k ) const;  // Binary (*) Scalar
+};
+
+template<typename K, typename T, std::size_t N, typename = typename std::enable_if<std::is_arithmetic<K>::value>::type>
+constexpr FixedPolynomial<T, N> operator * ( const K k, const FixedPolynomial<T, N>& poly ) { return poly * k; }  // Binary (*) Scalar
+
+template<typename T, std::size_t N>
+constexpr FixedPolynomial<T, N>::FixedPolynomial (std::initializer_list<T> coef) : c{}
+{
+	assert (coef.size() <= N + 1);  // Degree at most N
+	std::size_t i = N + 1 - coef.size();
+	for (const T* p = coef.begin(); p != coef.end(); ++p) c[i++] = *p;
+}
+
+template<typename T, std::size_t N>
+constexpr FixedPolynomial<T, N>::FixedPolynomial (const std::array<T, N + 1>& coef) : c{}
+{
+	for (std::size_t i = 0; i <= N; ++i) c[i] = coef[i];
+}
+
+template<typename T, std::size_t N>
+FixedPolynomial<T, N>::FixedPolynomial (const Polynomial& poly) : c{}
+{
+	const std::vector<double>& coef = poly.getCoefficients();
+	assert (coef.size() <= N + 1);  // Degree at most N
+	for (std::size_t i = 0; i < coef.size(); ++i) c[N + 1 - coef.size() + i] = T (coef[i]);
+}
+
+template<typename T, std::size_t N>
+constexpr int FixedPolynomial<T, N>::getDegree () const
+{
+	std::size_t lead = 0;
+	while (lead < N && c[lead] == T (0)) lead++;
+	return int (N - lead);
+}
+
+template<typename T, std::size_t N>
+constexpr T FixedPolynomial<T, N>::evaluate (const T x) const
+{
+	T y = c[0];
+	#pragma GCC unroll 32
+	for (std::size_t i = 1; i <= N; ++i) y = y * x + c[i];
+	return y;
+}
+
+template<typename T, std::size_t N>
+constexpr T FixedPolynomial<T, N>::derivativeEval (const T x) const
+{
+	T y = c[0], d = T (0);
+	#pragma GCC unroll 32
+	for (std::size_t i = 1; i <= N; ++i) {
+		d = d * x + y;
+		y = y * x + c[i];
+	}
+	return d;
+}
+
+template<typename T, std::size_t N>
+constexpr FixedPolynomial<T, (N > 0 ? N - 1 : 0)> FixedPolynomial<T, N>::derivativePoly () const
+{
+	FixedPolynomial<T, (N > 0 ? N - 1 : 0)> r{T (0)};
+	for (std::size_t i = 0; i < N; ++i) r.c[i] = T (N - i) * c[i];
+	return r;
+}
+
+template<typename T, std::size_t N>
+template<std::size_t M>
+constexpr bool FixedPolynomial<T, N>::operator == ( const FixedPolynomial<T, M>& poly ) const
+{
+	for (std::size_t k = 0; k <= (N > M ? N : M); ++k) {
+		if (coefficient(k) != poly.coefficient(k)) return false;
+	}
+	return true;
+}
+
+template<typename T, std::size_t N>
+template<std::size_t M, int Sign>
+constexpr FixedPolynomial<T, (N > M ? N : M)> FixedPolynomial<T, N>::sum (const FixedPolynomial<T, M>& poly) const
+{
+	FixedPolynomial<T, (N > M ? N : M)> r{T (0)};
+	for (std::size_t k = 0; k <= (N > M ? N : M); ++k) {
+		r.c[(N > M ? N : M) - k] = Sign > 0 ? coefficient(k) + poly.coefficient(k) : coefficient(k) - poly.coefficient(k);
+	}
+	return r;
+}
+
+template<typename T, std::size_t N>
+template<std::size_t M>
+constexpr FixedPolynomial<T, N + M> FixedPolynomial<T, N>::operator * ( const FixedPolynomial<T, M>& poly ) const
+{
+	FixedPolynomial<T, N + M> r{T (0)};
+	#pragma GCC unroll 32
+	for (std::size_t i = 0; i <= N; ++i) {
+		#pragma GCC unroll 32
+		for (std::size_t j = 0; j <= M; ++j) r.c[i + j] += c[i] * poly.c[j];
+	}
+	return r;
+}
+
+template<typename T, std::size_t N>
+template<typename K, typename>
+constexpr FixedPolynomial<T, N> FixedPolynomial<T, N>::operator * ( const K k ) const
+{
+	FixedPolynomial r(*this);
+	for (std::size_t i = 0; i <= N; ++i) r.c[i] *= k;
+	return r;
+}
+
+#endif
@@ -1,5 +1,8 @@
+#include <algorithm>  // func: std::min()
+#include <cassert>  // func: assert()
 #include <cmath>  // Mathematical Operations
 #include <list>  // Type: std::list - std::vector<double>
+#include <utility>  // func: std::move()
 
 #include "Polynomial.h"
 // #include <iostream> // For debugging
@@ -19,40 +22,29 @@ Polynomial::Polynomial ()
 
 Polynomial::Polynomial (const double* coef)
 {
-	vector<double> temp(coef, coef+sizeof(coef));
-	temp = Polynomial::truncateVec(temp);
-	Polynomial::coefficients = temp;
-	Polynomial:degree = temp.size() - 1;
+	Polynomial::coefficients.assign(coef, coef+sizeof(coef));
+	Polynomial::trim();
 }
 
 Polynomial::Polynomial (vector<double> coef)
 {
-	coef = Polynomial::truncateVec(coef);
-	Polynomial::coefficients = coef;
-	Polynomial::degree = coef.size() - 1;
-}
-
-Polynomial::~Polynomial ()
-{
-	Polynomial::coefficients.clear();
+	Polynomial::coefficients = move(coef);
+	Polynomial::trim();
 }
 
 void Polynomial::setCoefficients (const double* coef)
 {
-	vector<double> temp(coef, coef+sizeof(coef));
-	temp = Polynomial::truncateVec(temp);
-	Polynomial::coefficients = temp;
-	Polynomial:degree = temp.size() - 1;
+	Polynomial::coefficients.assign(coef, coef+sizeof(coef));
+	Polynomial::trim();
 }
 
 void Polynomial::setCoefficients (vector<double> coef)
 {
-	coef = Polynomial::truncateVec(coef);
-	Polynomial::coefficients = coef;
-	Polynomial::degree = coef.size() - 1;
+	Polynomial::coefficients = move(coef);
+	Polynomial::trim();
 }
 
-vector<double> Polynomial::getCoefficients () const
+const vector<double>& Polynomial::getCoefficients () const
 {
 	return Polynomial::coefficients;
 }
@@ -68,53 +60,13 @@ vector<double> Polynomial::arrayToVec (double* arr)  // Static, Private method f
 	return tempVec;
 }
 
-vector<double> Polynomial::truncateVec (vector<double> vec)  // Truncate leading zeros (for optimizaiton and comparison)
+void Polynomial::trim ()  // Truncate leading zeros (for optimizaiton and comparison), without reallocating
 {
-	vector<double>::iterator iter = vec.begin();
-	while (*iter == 0 && iter != vec.end()-1) {iter ++;}
-	vector<double> newVec(iter, vec.end());
-
-	return newVec;
-}
-
-vector<double> Polynomial::addVec (vector<double> vec1, vector<double> vec2)  // Adds vectors in the "coefficient" style
-{
-	// if (vec2 == Polynomial::nullVec) return vec1;  // Filter out null vectors (not sure if necessary)
-	if (vec1.size() < vec2.size()) return Polynomial::addVec (vec2, vec1);
-
-	vector<double>::reverse_iterator riter = vec1.rbegin();
-	for (vector<double>::reverse_iterator i = vec2.rbegin(); i != vec2.rend(); ++i) {
-		*riter += *i;
-		riter++;
-	}
-	return vec1;
-}
-
-vector<double> Polynomial::multiplyScalarVec (vector<double> vec, double scalar)  // defaults to -1 (acts as flip())
-{
-	if (!scalar) return Polynomial::nullVec;  // Case: scalar == 0 (or scalar = Null?)
-	for (vector<double>::iterator i = vec.begin(); i != vec.end(); ++i) {
-		*i *= scalar;
-	}
-	return vec;
-}
-
-vector<double> Polynomial::subtractVec (vector<double> vec1, vector<double> vec2)  // Subtracts vectors in the "coefficient" style: vec1 - vec2.
-{
-	return Polynomial::addVec(vec1, Polynomial::multiplyScalarVec(vec2));
-}
-
-vector<double> Polynomial::productVec (vector<double> vec1, vector<double> vec2)  // Multiplies vectors in the "coefficient" style
-{
-	if (vec1.size() > vec2.size()) return Polynomial::productVec(vec2, vec1);
-	vector<double> product = Polynomial::nullVec;
-	vector<double>::iterator iter;
-	for (iter = vec1.begin(); iter != vec1.end()-1; ++iter) {
-		product = Polynomial::addVec(Polynomial::multiplyScalarVec(vec2, *iter), product);
-		product.push_back(0);
-	}
- 	product = Polynomial::addVec(Polynomial::multiplyScalarVec(vec2, *iter), product);
- 	return product;
+	if (Polynomial::coefficients.empty()) Polynomial::coefficients.push_back(0);
+	size_t lead = 0;
+	while (lead + 1 < Polynomial::coefficients.size() && Polynomial::coefficients[lead] == 0) lead++;
+	Polynomial::coefficients.erase(Polynomial::coefficients.begin(), Polynomial::coefficients.begin() + lead);
+	Polynomial::degree = Polynomial::coefficients.size() - 1;
 }
 
 bool Polynomial::equals (const Polynomial& poly) const
@@ -124,33 +76,48 @@ bool Polynomial::equals (const Polynomial& poly) const
 
 Polynomial& Polynomial::add (const Polynomial& poly)
 {
-	setCoefficients(addVec(Polynomial::coefficients, poly.getCoefficients()));
-	return *this;
+	return Polynomial::assign(*this + poly);
 }
 
 Polynomial& Polynomial::subtract (const Polynomial& poly)
 {
-	setCoefficients(subtractVec(Polynomial::coefficients, poly.getCoefficients()));
-	return *this;
+	return Polynomial::assign(*this - poly);
 }
 
 Polynomial& Polynomial::multiply (const Polynomial& poly)
 {
-	setCoefficients(productVec(Polynomial::coefficients, poly.getCoefficients()));
+	const size_t n = Polynomial::coefficients.size(), m = poly.coefficients.size();
+	if (&poly == this || min(n, m) > Polynomial::schoolbookMax) {
+		Polynomial::coefficients = Polynomial::productVec(Polynomial::coefficients, poly.coefficients);
+		Polynomial::trim();
+		return *this;
+	}
+	// Small factor: schoolbook in place, lowest term first. Term k of the product only needs terms i <= k of this,
+	// and those sit at or before the slot it overwrites, so nothing is read after it is replaced
+	const size_t total = n + m - 1;
+	Polynomial::coefficients.resize(total);
+	double* c = Polynomial::coefficients.data();
+	const double* b = poly.coefficients.data();
+	for (size_t k = 0; k < total; ++k) {
+		const size_t lo = k >= m ? k - m + 1 : 0, hi = min(k, n - 1);
+		double sum = 0;
+		for (size_t i = lo; i <= hi; ++i) sum += c[n - 1 - i] * b[m - 1 - (k - i)];
+		c[total - 1 - k] = sum;
+	}
+	Polynomial::trim();
 	return *this;
 }
 
 Polynomial& Polynomial::scalarMultiply (const double k)
 {
-	setCoefficients(multiplyScalarVec(Polynomial::coefficients, k));
-	return *this;
+	return Polynomial::assign(*this * k);
 }
 
 // Calculation Methods
 
 double Polynomial::intPow (double x, int n) //(Private) Optimized, should be a bit faster than std::pow(double, int)
 {
-	if (n <= 0) return (n == 0) ? 1 : (1 / Polynomial::intPow(x, n));
+	if (n <= 0) return (n == 0) ? 1 : (1 / Polynomial::intPow(x, -n));
 	double y = x;
 	for (int i = n-1; i--;){
 		y *= x;
@@ -169,28 +136,14 @@ int Polynomial::factorialBetween (int b, int a)  // Special Factorial, (a, b]: (
 	return n;
 }
 
-double Polynomial::evaluate (double x)
-{
-	double y = 0;
-	int pow = 0;
-	for (vector<double>::reverse_iterator i = Polynomial::coefficients.rbegin(); i != Polynomial::coefficients.rend(); ++i) {
-		y += Polynomial::intPow(x, pow) * (*i);
-		pow++;
-	}
-	return y;
-}
-/* Alternatively: This is the same as above but slower. It works similar to the derivative method, for reference.
-double Polynomial::evaluate (double x)
+double Polynomial::evaluate (double x) const  // Horner's rule: n multiply-adds
 {
 	double y = 0;
-	int pow = Polynomial::degree;
-	for (vector<double>::iterator i = Polynomial::coefficients.begin(); i != Polynomial::coefficients.end(); ++i) {
-		y += Polynomial::intPow(x, pow) * (*i);
-		pow--;
+	for (vector<double>::const_iterator i = Polynomial::coefficients.begin(); i != Polynomial::coefficients.end(); ++i) {
+		y = y * x + (*i);
 	}
 	return y;
 }
-*/
 
 double Polynomial::derivativeEval (double x, int der)
 {
@@ -199,7 +152,7 @@ double Polynomial::derivativeEval (double x, int der)
 	int pow = Polynomial::degree;
 	if (der > pow) return 0;
 	for (vector<double>::iterator i = Polynomial::coefficients.begin(); i != Polynomial::coefficients.end() && pow >= der; ++i) {
-		y += (*i) * Polynomial::factorialBetween(pow, pow-der) * intPow(x, pow-der);
+		y = y * x + (*i) * Polynomial::factorialBetween(pow, pow-der);  // Horner on the derivative's coefficients
 		pow--;
 	}
 	return y;
@@ -221,13 +174,16 @@ Polynomial Polynomial::derivativePoly (int der)
 double Polynomial::integralEval(double a, double b, int inte)
 {
 	assert (inte > 0);  // Integration must be a strictly positive integer
-	double y = 0;
-	int pow = 0;
-	for (vector<double>::reverse_iterator i = Polynomial::coefficients.rbegin(); i != Polynomial::coefficients.rend(); ++i) {
-		y += (Polynomial::intPow(b, pow+inte) - Polynomial::intPow(a, pow+inte)) / Polynomial::factorialBetween(pow+inte, pow) * (*i);
-		pow++;
+	// Horner on the integral's coefficients at both ends, then the inte factors of x the integral's lowest terms lack
+	double ya = 0, yb = 0;
+	int pow = Polynomial::degree;
+	for (vector<double>::iterator i = Polynomial::coefficients.begin(); i != Polynomial::coefficients.end(); ++i) {
+		const double c = (*i) / Polynomial::factorialBetween(pow+inte, pow);
+		ya = ya * a + c;
+		yb = yb * b + c;
+		pow--;
 	}
-	return y;
+	return yb * Polynomial::intPow(b, inte) - ya * Polynomial::intPow(a, inte);
 }
 
 Polynomial Polynomial::integralPoly(int inte)  // Returns the most basic integral, new terms have coefficient zero
@@ -245,13 +201,7 @@ Polynomial Polynomial::integralPoly(int inte)  // Returns the most basic integra
 
 double Polynomial::antiderivativeEval (double a, double b)
 {
-	double y = 0;
-	int pow = 0;
-	for (vector<double>::reverse_iterator i = Polynomial::coefficients.rbegin(); i != Polynomial::coefficients.rend(); ++i) {
-		y += (Polynomial::intPow(b, pow) - Polynomial::intPow(a, pow)) * (*i);
-		pow++;
-	}
-	return y;
+	return Polynomial::evaluate(b) - Polynomial::evaluate(a);
 }
 
 // More Applied Calculation Methods
@@ -1,23 +1,46 @@
 #ifndef POLYNOMIAL_H
 #define POLYNOMIAL_H
 
+#include <algorithm>
+#include <cstddef>
+#include <utility>
 #include <vector>
 #include <string>
 
-class Polynomial
+#include "PolynomialExpr.h"
+#include "../Complex Numbers/Complex.h"
+
+class Polynomial : public PolyExpr<Polynomial>
 {
 	private:
 		std::vector<double> coefficients;
 		int degree;
 		
+		static double intPow (double x, int n);  // x^n for integer n
 		static int factorialBetween (int b, int a = 0);  // Special Factorial b!/a!
 		static std::vector<double> arrayToVec(double* arr);  // For converting double* to std::vector<double>
-		static std::vector<double> truncateVec(std::vector<double> vec);  // Truncate leading zeros (for optimizaiton and comparison)
+		void trim ();  // Drops leading zeros in place (keeping one term) and updates degree
+		template<typename E> Polynomial& assign (const PolyExpr<E>& expr);  // Writes expr into coefficients, reusing their capacity
+
+		// Multiplication engine (PolynomialMultiply.cpp): schoolbook, then Karatsuba, then FFT as the shorter factor grows
+		static const size_t schoolbookMax;  // Shorter factor up to this many terms: schoolbook
+		static const size_t karatsubaBase;  // Karatsuba recursion bottoms out in schoolbook at this size
+		static const size_t fftMin;  // Shorter factor from this many terms: FFT
+		static void schoolbookProduct (const double* a, size_t n, const double* b, size_t m, double* out);  // out[0, n+m-1) += a*b
+		static void karatsubaProduct (const double* a, const double* b, size_t n, double* out, double* scratch);  // out[0, 2n-1) = a*b, scratch holds 6n
+		static std::vector<double> karatsubaVec (const std::vector<double>& vec1, const std::vector<double>& vec2);  // vec1 no longer than vec2
+		static std::vector<double> fftVec (const std::vector<double>& vec1, const std::vector<double>& vec2);
+
+		// Division (PolynomialDivide.cpp): long division, or Newton's iteration on the reversed divisor for large sizes, O(M(n))
+		static const size_t newtonDivisionMin;  // Divisor and quotient both longer than this: Newton
+		static std::vector<double> inverseSeries (const std::vector<double>& f, const size_t k);  // First k terms of 1/f, f read lowest term first
+		static void divideVec (const std::vector<double>& a, const std::vector<double>& b, std::vector<double>* quotient, std::vector<double>* remainder);  // Either output may be null
 
-		static std::vector<double> multiplyScalarVec (std::vector<double> vec, double scalar = -1);  // defaults to -1 (acts as flip())
-		static std::vector<double> addVec (std::vector<double> vec1, std::vector<double> vec2);  // Adds vectors in the "coefficient" style
-		static std::vector<double> subtractVec (std::vector<double> vec1, std::vector<double> vec2);  // Subtracts vectors in the "coefficient" style: vec1 - vec2.
-		//static std::vector<double> productVec (std::vector<double> vec1, std::vector<double> vec2);  // Multiplies vectors in the "coefficient" style
+		// Subproduct trees (PolynomialMultipoint.cpp)
+		typedef std::vector<std::vector<std::vector<double> > > SubproductTree;  // [level][node], leaves first: products of (x - x_i) over runs of points
+		static const size_t treeLeaf;  // Points per leaf
+		static SubproductTree subproductTree (const std::vector<double>& xs);
+		static void multipointVec (const std::vector<double>& coef, const std::vector<double>& xs, const SubproductTree& tree, double* ys);
 
 		static const std::vector<double> nullVec;  // The standard (smallest) null/emtpy vector
 		static const Polynomial nullPoly;  // The standard (smallest) null/empty polynomial. Note: Nullpoly also has degree 0.
@@ -27,48 +50,103 @@ class Polynomial
 	public:
 		Polynomial ();  // No specification result in a unit polynomial (to prevent undefined errors)
 		Polynomial (const double* coef);
-		Polynomial (std::vector<double> coef);
-		~Polynomial ();
+		Polynomial (std::vector<double> coef);  // Moved in when passed an rvalue
+		template<typename E> Polynomial (const PolyExpr<E>& expr) : degree(0) { assign(expr); }
+		Polynomial (const Polynomial& poly) = default;
+		Polynomial (Polynomial&& poly) = default;
 		void setCoefficients (const double* coef);
 		void setCoefficients (std::vector<double> coef);
-		std::vector<double> getCoefficients () const;
+		const std::vector<double>& getCoefficients () const;
 		int getDegree () const;
 
+		// Expression protocol (see PolynomialExpr.h)
+		size_t size () const { return coefficients.size(); }
+		double coefficient (const size_t k) const { return k < coefficients.size() ? coefficients[coefficients.size() - 1 - k] : 0; }  // Of x^k
+		bool aliases (const Polynomial* p) const { return p == this; }
+
 		// Operations
 		bool equals (const Polynomial& poly) const;
 		Polynomial& add (const Polynomial& poly);
 		Polynomial& subtract (const Polynomial& poly);
 		Polynomial& multiply (const Polynomial& poly);
 		Polynomial& scalarMultiply (const double k);
+		Polynomial& divide (const Polynomial& poly);  // Keeps the quotient
+		Polynomial& modulo (const Polynomial& poly);  // Keeps the remainder
+		void divmod (const Polynomial& poly, Polynomial& quotient, Polynomial& remainder) const;  // this = poly * quotient + remainder, deg remainder < deg poly
 
 		bool isNull () const { return coefficients == nullVec; }  // In case this is useful
 
-		// Operators
-		Polynomial& operator = ( const Polynomial& poly ) { setCoefficients(poly.getCoefficients()); return *this; }  // Assignment (=)
+		// Operators (+, - and scalar * build expressions, see PolynomialExpr.h)
+		Polynomial& operator = ( const Polynomial& poly ) = default;  // Assignment (=), reuses capacity
+		Polynomial& operator = ( Polynomial&& poly ) = default;  // Assignment (=), takes the buffer
+		template<typename E> Polynomial& operator = ( const PolyExpr<E>& expr ) { return assign(expr); }  // Assignment (=) of an expression, in one pass
 		bool operator == ( const Polynomial& poly ) const { return equals(poly); }  // Binary Comparison (==)
 		bool operator != ( const Polynomial& poly ) const { return !equals(poly); }  // Binary Comparison (!=)
-		Polynomial operator + ( const Polynomial& poly ) const { return Polynomial(addVec(coefficients, poly.getCoefficients())); }  // Binary (+)
-		Polynomial operator - ( const Polynomial& poly ) const { return Polynomial(subtractVec(coefficients, poly.getCoefficients())); }  // Binary (-)
-		Polynomial operator * ( const Polynomial& poly ) const { return Polynomial(productVec(coefficients, poly.getCoefficients())); }  // Binary (*)
-		Polynomial operator * ( const double k ) const { return Polynomial(multiplyScalarVec(coefficients, k)); }  // Binary (*) Scalar
-		Polynomial& operator += ( const Polynomial& poly ) { return add(poly); }  // Assignment (+=)
-		Polynomial& operator -= ( const Polynomial& poly ) { return subtract(poly); }  // Assignment (-=)
+		template<typename E> Polynomial& operator += ( const PolyExpr<E>& expr ) { return assign(*this + expr); }  // Assignment (+=)
+		template<typename E> Polynomial& operator -= ( const PolyExpr<E>& expr ) { return assign(*this - expr); }  // Assignment (-=)
 		Polynomial& operator *= ( const Polynomial& poly ) { return multiply(poly); }  // Assignment (*=)
 		Polynomial& operator *= ( const double k ) { return scalarMultiply(k); }  // Assignment (*=)
+		Polynomial& operator /= ( const Polynomial& poly ) { return divide(poly); }  // Assignment (/=)
+		Polynomial& operator %= ( const Polynomial& poly ) { return modulo(poly); }  // Assignment (%=)
 
 		// Calculations
-		double evaluate (double x);
+		double evaluate (double x) const;  // Horner's rule
+		void evaluate (const double* xs, double* ys, const size_t n, int threads = 1) const;  // ys[i] = p(xs[i]), SIMD lanes where available; threads <= 0 uses every core
+		std::vector<double> evaluate (const std::vector<double>& xs, bool tree = false) const;  // Many points: the batch kernels, or with tree a subproduct tree, O(n log^2 n) but accurate only for points near 0
+		static const char* evaluateKernelName ();  // Kernel the batch evaluate picked for this CPU: "avx512", "avx2" or "scalar"
 		double derivativeEval (double x, int der = 1);
 		double integralEval (double a, double b, int inte = 1);  // S(a, b)
 		Polynomial derivativePoly (int der = 1);
 		Polynomial integralPoly (int inte = 1);  // In the most basic (using 0s) +C form
-		double antiderivativeEval (double a, double b);  // Faster method of eval(b) - eval(a) for calculating area under derivative.
+		double antiderivativeEval (double a, double b);  // eval(b) - eval(a), the area under the derivative
 
 		// Applications
 		static double newtonApprox(Polynomial poly, double g = 0, int max = 10);  // g is the initial guess. max is max tries
 		static long double newtonApproxL(Polynomial poly, long double g = 0, int max = 10);  // for more precision
+		std::vector<Complex> roots (std::vector<double>* radii = nullptr, const int threads = 1) const;  // Every complex root (Aberth-Ehrlich); the discs of radii[i] around them contain all roots
+		static Polynomial gcd (const Polynomial& a, const Polynomial& b, const double tolerance = 1e-10);  // Monic; terms below tolerance (relative) count as zero
+		static Polynomial interpolate (const std::vector<double>& xs, const std::vector<double>& ys, bool tree = false);  // Through the n points (xs distinct), degree < n, without the differences lost to rounding; with tree O(n log^2 n) but unstable
 
-		static std::vector<double> productVec (std::vector<double> vec1, std::vector<double> vec2);
+		static std::vector<double> productVec (const std::vector<double>& vec1, const std::vector<double>& vec2);  // Multiplies vectors in the "coefficient" style
 };
 
-#endif
\ No newline at end of file
+// Products are not coefficient-wise, so they are computed on the spot (an rvalue left factor lends its buffer)
+inline Polynomial operator * ( const Polynomial& a, const Polynomial& b ) { return Polynomial(Polynomial::productVec(a.getCoefficients(), b.getCoefficients())); }  // Binary (*)
+inline Polynomial operator * ( Polynomial&& a, const Polynomial& b ) { a.multiply(b); return std::move(a); }  // Binary (*)
+inline Polynomial operator / ( const Polynomial& a, const Polynomial& b ) { Polynomial q(a); q.divide(b); return q; }  // Binary (/)
+inline Polynomial operator % ( const Polynomial& a, const Polynomial& b ) { Polynomial r(a); r.modulo(b); return r; }  // Binary (%)
+inline PolyScaled<Polynomial> operator * ( const Polynomial& poly, const double k ) { return PolyScaled<Polynomial>(poly, k); }  // Binary (*) Scalar
+inline PolyScaled<Polynomial> operator * ( const double k, const Polynomial& poly ) { return PolyScaled<Polynomial>(poly, k); }  // Binary (*) Scalar
+
+template<typename E>
+Polynomial& Polynomial::assign (const PolyExpr<E>& expr)
+{
+	const E& e = expr.self();
+	const size_t n = e.size(), old = Polynomial::coefficients.size();
+	Polynomial::coefficients.resize(n);
+	if (e.aliases(this) && n > old) {
+		// Growing under itself: the old terms move to the back, so this reads as zeros in the new high terms
+		std::move_backward(Polynomial::coefficients.begin(), Polynomial::coefficients.begin() + old, Polynomial::coefficients.end());
+		std::fill(Polynomial::coefficients.begin(), Polynomial::coefficients.begin() + (n - old), 0.0);
+	}
+	// Term k only reads term k of each operand, so writing over an aliased operand is safe
+	for (size_t k = 0; k < n; ++k) {
+		Polynomial::coefficients[n - 1 - k] = e.coefficient(k);
+	}
+	Polynomial::trim();
+	return *this;
+}
+
+template<typename E>
+std::vector<double> PolyExpr<E>::getCoefficients () const
+{
+	return Polynomial(self()).getCoefficients();
+}
+
+template<typename E>
+int PolyExpr<E>::getDegree () const
+{
+	return Polynomial(self()).getDegree();
+}
+
+#endif
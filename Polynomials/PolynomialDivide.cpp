@@ -0,0 +1,133 @@
+#include <algorithm>  // func: std::min(), std::max()
+#include <cassert>  // func: assert()
+#include <cmath>  // func: std::abs()
+#include <cstddef>  // Type: size_t
+#include <utility>  // func: std::move()
+#include <vector>  // Type: std::vector
+
+#include "Polynomial.h"
+
+using namespace std;
+
+// Division on coefficient vectors (highest term first). Read lowest-first, such a vector is the reversed polynomial,
+// and reversal turns the quotient into a power series: rev(q) = rev(a) / rev(b) mod x^(n-m+1). So the fast path inverts
+// b as a series by Newton's iteration and needs only a couple of products, O(M(n)) overall.
+
+const size_t Polynomial::newtonDivisionMin = 512;
+
+vector<double> Polynomial::inverseSeries (const vector<double>& f, const size_t k)
+{
+	// g <- g (2 - f g), doubling the number of correct terms every step
+	vector<double> g(1, 1 / f[0]);
+	for (size_t length = 1; length < k;) {
+		length = min(2 * length, k);
+		vector<double> e = Polynomial::productVec(vector<double>(f.begin(), f.begin() + min(length, f.size())), g);
+		e.resize(length, 0.0);
+		for (size_t i = 0; i < length; ++i) e[i] = -e[i];
+		e[0] += 2;
+		g = Polynomial::productVec(g, e);
+		g.resize(length, 0.0);
+	}
+	return g;
+}
+
+void Polynomial::divideVec (const vector<double>& a, const vector<double>& b, vector<double>* quotient, vector<double>* remainder)
+{
+	const size_t n = a.size(), m = b.size();
+	if (n < m) {
+		if (quotient) *quotient = Polynomial::nullVec;
+		if (remainder) *remainder = a;
+		return;
+	}
+	const size_t k = n - m + 1;  // Quotient terms
+	vector<double> q;
+	vector<double> r;
+	if (m <= Polynomial::newtonDivisionMin || k <= Polynomial::newtonDivisionMin) {
+		// Long division
+		r = a;
+		q.resize(k);
+		for (size_t i = 0; i < k; ++i) {
+			const double c = r[i] / b[0];
+			q[i] = c;
+			for (size_t j = 1; j < m; ++j) r[i + j] -= c * b[j];
+		}
+		r.erase(r.begin(), r.begin() + k);
+	}
+	else {
+		q = Polynomial::productVec(vector<double>(a.begin(), a.begin() + k), Polynomial::inverseSeries(b, k));
+		q.resize(k, 0.0);
+		if (remainder) {
+			vector<double> bq = Polynomial::productVec(b, q);
+			bq.insert(bq.begin(), n - min(n, bq.size()), 0.0);  // A zero quotient comes back as a single term
+			r.resize(m - 1);
+			for (size_t i = 0; i < m - 1; ++i) r[i] = a[k + i] - bq[k + i];
+		}
+	}
+	// Trimmed like any Polynomial; an empty remainder (constant b) becomes the null vector
+	if (quotient) {
+		Polynomial trimmed(move(q));
+		quotient->swap(trimmed.coefficients);
+	}
+	if (remainder) {
+		Polynomial trimmed(move(r));
+		remainder->swap(trimmed.coefficients);
+	}
+}
+
+void Polynomial::divmod (const Polynomial& poly, Polynomial& quotient, Polynomial& remainder) const
+{
+	assert (!poly.isNull());  // Division by the null polynomial
+	vector<double> q, r;
+	Polynomial::divideVec(Polynomial::coefficients, poly.coefficients, &q, &r);
+	quotient.setCoefficients(move(q));
+	remainder.setCoefficients(move(r));
+}
+
+Polynomial& Polynomial::divide (const Polynomial& poly)
+{
+	assert (!poly.isNull());  // Division by the null polynomial
+	vector<double> q;
+	Polynomial::divideVec(Polynomial::coefficients, poly.coefficients, &q, nullptr);
+	Polynomial::setCoefficients(move(q));
+	return *this;
+}
+
+Polynomial& Polynomial::modulo (const Polynomial& poly)
+{
+	assert (!poly.isNull());  // Division by the null polynomial
+	vector<double> r;
+	Polynomial::divideVec(Polynomial::coefficients, poly.coefficients, nullptr, &r);
+	Polynomial::setCoefficients(move(r));
+	return *this;
+}
+
+Polynomial Polynomial::gcd (const Polynomial& a, const Polynomial& b, const double tolerance)
+{
+	// Euclid on copies scaled to unit max-norm. Rounding leaves each remainder with tiny leading terms where exact
+	// arithmetic would have cancelled them, so terms below tolerance (relative to the dividend) are dropped first.
+	// (Half-GCD is not used: it saves time only by skipping these per-step judgements, which is where the accuracy is.)
+	auto normalized = [](vector<double> v) {
+		double scale = 0;
+		for (double c : v) scale = max(scale, abs(c));
+		if (scale > 0) {
+			for (double& c : v) c /= scale;
+		}
+		return v;
+	};
+	vector<double> u = normalized(a.coefficients), v = normalized(b.coefficients);
+	if (u.size() < v.size()) u.swap(v);
+	while (!(v.size() == 1 && v[0] == 0)) {
+		vector<double> r;
+		Polynomial::divideVec(u, v, nullptr, &r);
+		size_t lead = 0;
+		while (lead < r.size() && abs(r[lead]) <= tolerance) lead++;
+		r.erase(r.begin(), r.begin() + lead);
+		if (r.empty()) r = Polynomial::nullVec;
+		u.swap(v);
+		v = normalized(move(r));
+	}
+	if (u.size() == 1 && u[0] == 0) return Polynomial::nullPoly;  // gcd(0, 0)
+	const double lead = u[0];
+	for (double& c : u) c /= lead;
+	return Polynomial(move(u));
+}
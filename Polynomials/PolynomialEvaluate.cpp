@@ -0,0 +1,162 @@
+#include <algorithm>  // func: std::min(), std::copy()
+#include <cstddef>  // Type: size_t
+#include <thread>  // Type: std::thread
+#include <vector>  // Type: std::vector
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>  // AVX2 / AVX-512 intrinsics
+#define POLYNOMIAL_X86 1
+#endif
+
+#include "Polynomial.h"
+
+using namespace std;
+
+// Batch evaluation: Horner's rule run on several points at once, one point per lane, with four independent vectors in
+// flight so the multiply-add latency is hidden. The vector kernels use fused multiply-add, so their results may differ
+// from evaluate(x) in the last bit.
+
+typedef void (*EvalKernel) (const double* coef, size_t terms, const double* xs, double* ys, size_t n);
+
+static const size_t pointsPerThread = 1 << 14;  // Below this a thread costs more than it saves
+
+static void hornerScalar (const double* coef, size_t terms, const double* xs, double* ys, size_t n)
+{
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		const double x0 = xs[i], x1 = xs[i + 1], x2 = xs[i + 2], x3 = xs[i + 3];
+		double y0 = coef[0], y1 = coef[0], y2 = coef[0], y3 = coef[0];
+		for (size_t k = 1; k < terms; ++k) {
+			y0 = y0 * x0 + coef[k];
+			y1 = y1 * x1 + coef[k];
+			y2 = y2 * x2 + coef[k];
+			y3 = y3 * x3 + coef[k];
+		}
+		ys[i] = y0;
+		ys[i + 1] = y1;
+		ys[i + 2] = y2;
+		ys[i + 3] = y3;
+	}
+	for (; i < n; ++i) {
+		double y = coef[0];
+		for (size_t k = 1; k < terms; ++k) y = y * xs[i] + coef[k];
+		ys[i] = y;
+	}
+}
+
+#ifdef POLYNOMIAL_X86
+
+__attribute__((target("avx2,fma")))
+static void hornerAvx2 (const double* coef, size_t terms, const double* xs, double* ys, size_t n)
+{
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		const __m256d x0 = _mm256_loadu_pd(xs + i), x1 = _mm256_loadu_pd(xs + i + 4);
+		const __m256d x2 = _mm256_loadu_pd(xs + i + 8), x3 = _mm256_loadu_pd(xs + i + 12);
+		__m256d y0 = _mm256_set1_pd(coef[0]), y1 = y0, y2 = y0, y3 = y0;
+		for (size_t k = 1; k < terms; ++k) {
+			const __m256d c = _mm256_set1_pd(coef[k]);
+			y0 = _mm256_fmadd_pd(y0, x0, c);
+			y1 = _mm256_fmadd_pd(y1, x1, c);
+			y2 = _mm256_fmadd_pd(y2, x2, c);
+			y3 = _mm256_fmadd_pd(y3, x3, c);
+		}
+		_mm256_storeu_pd(ys + i, y0);
+		_mm256_storeu_pd(ys + i + 4, y1);
+		_mm256_storeu_pd(ys + i + 8, y2);
+		_mm256_storeu_pd(ys + i + 12, y3);
+	}
+	// The rest one vector at a time, the last few padded so every point goes through the same arithmetic
+	for (; i < n; i += 4) {
+		double xp[4] = {0, 0, 0, 0}, yp[4];
+		const size_t count = min<size_t>(4, n - i);
+		copy(xs + i, xs + i + count, xp);
+		const __m256d x = _mm256_loadu_pd(xp);
+		__m256d y = _mm256_set1_pd(coef[0]);
+		for (size_t k = 1; k < terms; ++k) y = _mm256_fmadd_pd(y, x, _mm256_set1_pd(coef[k]));
+		_mm256_storeu_pd(yp, y);
+		copy(yp, yp + count, ys + i);
+	}
+}
+
+__attribute__((target("avx512f")))
+static void hornerAvx512 (const double* coef, size_t terms, const double* xs, double* ys, size_t n)
+{
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32) {
+		const __m512d x0 = _mm512_loadu_pd(xs + i), x1 = _mm512_loadu_pd(xs + i + 8);
+		const __m512d x2 = _mm512_loadu_pd(xs + i + 16), x3 = _mm512_loadu_pd(xs + i + 24);
+		__m512d y0 = _mm512_set1_pd(coef[0]), y1 = y0, y2 = y0, y3 = y0;
+		for (size_t k = 1; k < terms; ++k) {
+			const __m512d c = _mm512_set1_pd(coef[k]);
+			y0 = _mm512_fmadd_pd(y0, x0, c);
+			y1 = _mm512_fmadd_pd(y1, x1, c);
+			y2 = _mm512_fmadd_pd(y2, x2, c);
+			y3 = _mm512_fmadd_pd(y3, x3, c);
+		}
+		_mm512_storeu_pd(ys + i, y0);
+		_mm512_storeu_pd(ys + i + 8, y1);
+		_mm512_storeu_pd(ys + i + 16, y2);
+		_mm512_storeu_pd(ys + i + 24, y3);
+	}
+	// Masked loads and stores take the rest, a vector at a time
+	for (; i < n; i += 8) {
+		const __mmask8 mask = __mmask8 (n - i >= 8 ? 0xFF : (1u << (n - i)) - 1);
+		const __m512d x = _mm512_maskz_loadu_pd(mask, xs + i);
+		__m512d y = _mm512_set1_pd(coef[0]);
+		for (size_t k = 1; k < terms; ++k) y = _mm512_fmadd_pd(y, x, _mm512_set1_pd(coef[k]));
+		_mm512_mask_storeu_pd(ys + i, mask, y);
+	}
+}
+
+#endif
+
+static EvalKernel chooseKernel (const char*& name)
+{
+#ifdef POLYNOMIAL_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) {
+		name = "avx512";
+		return hornerAvx512;
+	}
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+		name = "avx2";
+		return hornerAvx2;
+	}
+#endif
+	name = "scalar";
+	return hornerScalar;
+}
+
+static const char* kernelName = "scalar";
+static const EvalKernel evalKernel = chooseKernel(kernelName);
+
+const char* Polynomial::evaluateKernelName ()
+{
+	return kernelName;
+}
+
+void Polynomial::evaluate (const double* xs, double* ys, const size_t n, int threads) const
+{
+	const double* coef = Polynomial::coefficients.data();
+	const size_t terms = Polynomial::coefficients.size();
+	if (threads <= 0) {
+		const unsigned hw = thread::hardware_concurrency();
+		threads = hw ? int (hw) : 1;
+	}
+	threads = int (min<size_t>(size_t (threads), n / pointsPerThread));
+	if (threads <= 1) {
+		evalKernel(coef, terms, xs, ys, n);
+		return;
+	}
+
+	// Contiguous chunks, the calling thread taking the first
+	const size_t chunk = (n + size_t (threads) - 1) / size_t (threads);
+	vector<thread> workers;
+	for (size_t start = chunk; start < n; start += chunk) {
+		const size_t count = min(chunk, n - start);
+		workers.emplace_back(evalKernel, coef, terms, xs + start, ys + start, count);
+	}
+	evalKernel(coef, terms, xs, ys, min(chunk, n));
+	for (thread& t : workers) t.join();
+}
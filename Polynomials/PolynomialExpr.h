@@ -0,0 +1,87 @@
+#ifndef POLYNOMIALEXPR_H
+#define POLYNOMIALEXPR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+class Polynomial;
+
+// Expression templates: sums, differences and scalings of polynomials are nodes that compute each coefficient on
+// demand, so a whole expression is written into the target in one pass. Nodes keep references to Polynomial
+// operands, so assign them to a Polynomial within the same statement (not to auto).
+// Every expression offers size() (number of terms), coefficient(k) (of x^k, 0 past the end) and aliases(p).
+
+template<typename E>
+class PolyExpr  // CRTP base of Polynomial and of every node
+{
+	public:
+		const E& self () const { return static_cast<const E&>(*this); }
+
+		// Materialized views (for printing and tests)
+		std::vector<double> getCoefficients () const;
+		int getDegree () const;
+		double evaluate (double x) const;  // Straight from the nodes, no temporary
+};
+
+template<typename E>
+struct PolyOperand  // How a node holds an operand: nodes by value, polynomials by reference
+{
+	typedef const E type;
+};
+
+template<>
+struct PolyOperand<Polynomial>
+{
+	typedef const Polynomial& type;
+};
+
+template<typename L, typename R, int Sign>
+class PolySum : public PolyExpr<PolySum<L, R, Sign> >  // l + r, or l - r with Sign = -1
+{
+	private:
+		typename PolyOperand<L>::type l;
+		typename PolyOperand<R>::type r;
+
+	public:
+		PolySum (const L& l, const R& r) : l(l), r(r) {}
+		size_t size () const { return std::max(l.size(), r.size()); }
+		double coefficient (const size_t k) const { return Sign > 0 ? l.coefficient(k) + r.coefficient(k) : l.coefficient(k) - r.coefficient(k); }
+		bool aliases (const Polynomial* p) const { return l.aliases(p) || r.aliases(p); }
+};
+
+template<typename E>
+class PolyScaled : public PolyExpr<PolyScaled<E> >  // k * e
+{
+	private:
+		typename PolyOperand<E>::type e;
+		double k;
+
+	public:
+		PolyScaled (const E& e, const double k) : e(e), k(k) {}
+		size_t size () const { return e.size(); }
+		double coefficient (const size_t i) const { return e.coefficient(i) * k; }
+		bool aliases (const Polynomial* p) const { return e.aliases(p); }
+};
+
+template<typename L, typename R>
+PolySum<L, R, 1> operator + ( const PolyExpr<L>& l, const PolyExpr<R>& r ) { return PolySum<L, R, 1>(l.self(), r.self()); }  // Binary (+)
+
+template<typename L, typename R>
+PolySum<L, R, -1> operator - ( const PolyExpr<L>& l, const PolyExpr<R>& r ) { return PolySum<L, R, -1>(l.self(), r.self()); }  // Binary (-)
+
+template<typename E>
+PolyScaled<E> operator * ( const PolyExpr<E>& e, const double k ) { return PolyScaled<E>(e.self(), k); }  // Binary (*) Scalar
+
+template<typename E>
+PolyScaled<E> operator * ( const double k, const PolyExpr<E>& e ) { return PolyScaled<E>(e.self(), k); }  // Binary (*) Scalar
+
+template<typename E>
+double PolyExpr<E>::evaluate (double x) const
+{
+	double y = 0;
+	for (size_t k = self().size(); k--;) y = y * x + self().coefficient(k);
+	return y;
+}
+
+#endif
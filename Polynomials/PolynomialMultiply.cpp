@@ -0,0 +1,174 @@
+#include <algorithm>  // func: std::min(), std::fill(), std::swap(), std::count()
+#include <cmath>  // func: std::cos(), std::sin()
+#include <complex>  // Type: std::complex<double>
+#include <vector>  // Type: std::vector
+
+#include "Polynomial.h"
+#include "SparsePolynomial.h"
+
+using namespace std;
+
+// Tuned on random coefficients at -O2 (see README)
+const size_t Polynomial::schoolbookMax = 32;
+const size_t Polynomial::karatsubaBase = 32;
+const size_t Polynomial::fftMin = 256;
+
+typedef complex<double> Cx;
+
+static inline Cx times (const Cx& a, const Cx& b)  // Plain product, without the NaN/Inf recovery of operator *
+{
+	return Cx(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+static const vector<Cx>& fftRoots (const size_t n)  // roots[k + j] = e^(-i pi j/k) for every power of two k < n, grown on demand
+{
+	static thread_local vector<Cx> roots(2, Cx(1, 0));
+	for (size_t k = roots.size(); k < n; k *= 2) {
+		roots.resize(2 * k);
+		for (size_t j = 0; j < k; ++j) {
+			const double angle = -M_PI * double (j) / double (k);  // Each root directly, so the error does not build up
+			roots[k + j] = Cx(cos(angle), sin(angle));
+		}
+	}
+	return roots;
+}
+
+static void fft (vector<Cx>& a, const bool inverse)  // In-place, iterative radix-2; size a power of two, the inverse unscaled
+{
+	const size_t n = a.size();
+	const vector<Cx>& roots = fftRoots(n);
+	for (size_t i = 1, j = 0; i < n; ++i) {
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1) j ^= bit;
+		j ^= bit;
+		if (i < j) swap(a[i], a[j]);
+	}
+	if (inverse) {
+		for (size_t i = 0; i < n; ++i) a[i] = conj(a[i]);
+	}
+	for (size_t k = 1; k < n; k *= 2) {
+		for (size_t i = 0; i < n; i += 2 * k) {
+			for (size_t j = 0; j < k; ++j) {
+				const Cx z = times(roots[k + j], a[i + j + k]);
+				a[i + j + k] = a[i + j] - z;
+				a[i + j] += z;
+			}
+		}
+	}
+	if (inverse) {
+		for (size_t i = 0; i < n; ++i) a[i] = conj(a[i]);
+	}
+}
+
+void Polynomial::schoolbookProduct (const double* a, size_t n, const double* b, size_t m, double* out)
+{
+	for (size_t i = 0; i < n; ++i) {
+		const double c = a[i];
+		double* row = out + i;
+		for (size_t j = 0; j < m; ++j) row[j] += c * b[j];
+	}
+}
+
+void Polynomial::karatsubaProduct (const double* a, const double* b, size_t n, double* out, double* scratch)
+{
+	if (n <= Polynomial::karatsubaBase) {
+		fill(out, out + 2 * n - 1, 0.0);
+		Polynomial::schoolbookProduct(a, n, b, n, out);
+		return;
+	}
+	// a = a0 + x^m a1 (likewise b): a*b = a0 b0 + x^m ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) + x^2m a1 b1
+	const size_t m = n / 2, h = n - m;
+	Polynomial::karatsubaProduct(a, b, m, out, scratch);
+	out[2 * m - 1] = 0;
+	Polynomial::karatsubaProduct(a + m, b + m, h, out + 2 * m, scratch);
+
+	double* sa = scratch;
+	double* sb = scratch + h;
+	double* mid = scratch + 2 * h;
+	for (size_t i = 0; i < h; ++i) {
+		sa[i] = a[m + i] + (i < m ? a[i] : 0);
+		sb[i] = b[m + i] + (i < m ? b[i] : 0);
+	}
+	Polynomial::karatsubaProduct(sa, sb, h, mid, scratch + 4 * h);
+	for (size_t i = 0; i < 2 * m - 1; ++i) mid[i] -= out[i];
+	for (size_t i = 0; i < 2 * h - 1; ++i) mid[i] -= out[2 * m + i];
+	for (size_t i = 0; i < 2 * h - 1; ++i) out[m + i] += mid[i];
+}
+
+vector<double> Polynomial::karatsubaVec (const vector<double>& vec1, const vector<double>& vec2)
+{
+	// The longer factor in slices as long as the shorter one, each slice one balanced Karatsuba product
+	const size_t n = vec1.size(), m = vec2.size();
+	vector<double> product(n + m - 1, 0.0), slice(n), part(2 * n - 1), scratch(6 * n + 64);
+	for (size_t offset = 0; offset < m; offset += n) {
+		const size_t length = min(n, m - offset);
+		copy(vec2.begin() + offset, vec2.begin() + offset + length, slice.begin());
+		fill(slice.begin() + length, slice.end(), 0.0);
+		Polynomial::karatsubaProduct(vec1.data(), slice.data(), n, part.data(), scratch.data());
+		const size_t end = min(2 * n - 1, n + m - 1 - offset);
+		for (size_t i = 0; i < end; ++i) product[offset + i] += part[i];
+	}
+	return product;
+}
+
+vector<double> Polynomial::fftVec (const vector<double>& vec1, const vector<double>& vec2)
+{
+	// Real input: each factor is packed two coefficients per complex value (even + i odd) into a half-length FFT,
+	// so the product takes three transforms of half the padded size
+	const size_t length = vec1.size() + vec2.size() - 1;
+	size_t size = 2;
+	while (size < length) size *= 2;
+	const size_t half = size / 2;
+
+	auto pack = [half](const vector<double>& vec) {
+		vector<Cx> z(half, Cx(0, 0));
+		for (size_t i = 0; i < vec.size(); ++i) {
+			if (i & 1) z[i / 2].imag(vec[i]);
+			else z[i / 2].real(vec[i]);
+		}
+		return z;
+	};
+	vector<Cx> za = pack(vec1), zb = pack(vec2), zc(half);
+	fft(za, false);
+	fft(zb, false);
+
+	// Even/odd spectra E, O of each factor from Z = E + iO; the product's are E = Ea Eb + w^2 Oa Ob and O = Ea Ob + Oa Eb
+	const vector<Cx>& roots = fftRoots(size);
+	for (size_t k = 0; k < half; ++k) {
+		const size_t r = (half - k) & (half - 1);
+		const Cx ea = (za[k] + conj(za[r])) * 0.5, oa = times(za[k] - conj(za[r]), Cx(0, -0.5));
+		const Cx eb = (zb[k] + conj(zb[r])) * 0.5, ob = times(zb[k] - conj(zb[r]), Cx(0, -0.5));
+		const Cx w = roots[half + k];  // e^(-2 pi i k/size)
+		const Cx even = times(ea, eb) + times(times(w, w), times(oa, ob));
+		const Cx odd = times(ea, ob) + times(oa, eb);
+		zc[k] = even + Cx(-odd.imag(), odd.real());
+	}
+	fft(zc, true);
+
+	vector<double> product(length);
+	const double scale = 1.0 / double (half);
+	for (size_t i = 0; i < length; ++i) {
+		product[i] = (i & 1 ? zc[i / 2].imag() : zc[i / 2].real()) * scale;
+	}
+	return product;
+}
+
+vector<double> Polynomial::productVec (const vector<double>& vec1, const vector<double>& vec2)  // Multiplies vectors in the "coefficient" style
+{
+	// Reversing both factors reverses the product, so the highest-first order needs no special handling
+	if (vec1.size() > vec2.size()) return Polynomial::productVec(vec2, vec1);
+	if (vec1 == Polynomial::nullVec || vec2 == Polynomial::nullVec) return Polynomial::nullVec;
+
+	// Mostly-zero factors (x^1000 + 1, say) go term by term, see SparsePolynomial.cpp
+	const size_t terms1 = vec1.size() - count(vec1.begin(), vec1.end(), 0.0), terms2 = vec2.size() - count(vec2.begin(), vec2.end(), 0.0);
+	if (SparsePolynomial::sparseProduct(terms1, vec1.size(), terms2, vec2.size())) {
+		return SparsePolynomial::coefficientsOf(SparsePolynomial::productTerms(SparsePolynomial::termsOf(vec1), SparsePolynomial::termsOf(vec2)), vec1.size() + vec2.size() - 1);
+	}
+	if (vec1.size() <= Polynomial::schoolbookMax) {
+		vector<double> product(vec1.size() + vec2.size() - 1, 0.0);
+		Polynomial::schoolbookProduct(vec1.data(), vec1.size(), vec2.data(), vec2.size(), product.data());
+		return product;
+	}
+	if (vec1.size() < Polynomial::fftMin) return Polynomial::karatsubaVec(vec1, vec2);
+	return Polynomial::fftVec(vec1, vec2);
+}
@@ -0,0 +1,174 @@
+#include <algorithm>  // func: std::min(), std::min_element(), std::max_element(), std::swap()
+#include <cassert>  // func: assert()
+#include <cmath>  // func: std::abs(), std::sqrt()
+#include <cstddef>  // Type: size_t
+#include <limits>  // func: std::numeric_limits<double>::epsilon()
+#include <utility>  // func: std::move()
+#include <vector>  // Type: std::vector
+
+#include "Polynomial.h"
+
+using namespace std;
+
+// Multipoint evaluation and interpolation on a subproduct tree: the leaves are products of (x - x_i) over runs of
+// treeLeaf points, and each node above is the product of its two children. Going down, a polynomial reduced modulo a
+// node still agrees with the original on that node's points, so O(n log^2 n) with fast multiplication and division.
+//
+// In floating point the tree is only as good as its node polynomials are small. A remainder modulo a node whose
+// coefficients run to 2^k loses about k bits, and for n real points spread over [-1, 1] they reach 2^n. Evaluation keeps
+// its digits while the points stay within a few times 1/sqrt(n) of 0 (and overflows not far beyond), and the Lagrange
+// sum of the interpolation cancels terms 2^n times its result for any real points. So callers ask for the tree; the default is Horner (SIMD) for evaluation,
+// and Newton's divided differences over Leja-ordered points for interpolation, O(n^2) both.
+//
+// Leja order (each point the farthest, by product of distances, from those before it) keeps the divided differences
+// from growing with n. Each one then carries a running estimate of its rounding error, and the trailing differences
+// within it are dropped: data from a low-degree polynomial comes back at that degree, whatever the number of points.
+
+static const double eps = numeric_limits<double>::epsilon();
+
+const size_t Polynomial::treeLeaf = 32;
+
+static void addAligned (vector<double>& into, const vector<double>& v)  // into += v, both highest term first
+{
+	if (into.size() < v.size()) into.insert(into.begin(), v.size() - into.size(), 0.0);
+	const size_t shift = into.size() - v.size();
+	for (size_t i = 0; i < v.size(); ++i) into[shift + i] += v[i];
+}
+
+Polynomial::SubproductTree Polynomial::subproductTree (const vector<double>& xs)
+{
+	SubproductTree tree(1);
+	for (size_t start = 0; start < xs.size(); start += Polynomial::treeLeaf) {
+		const size_t end = min(start + Polynomial::treeLeaf, xs.size());
+		vector<double> m(1, 1.0);
+		for (size_t i = start; i < end; ++i) {  // m *= (x - x_i)
+			m.push_back(0);
+			for (size_t j = m.size() - 1; j > 0; --j) m[j] -= xs[i] * m[j - 1];
+		}
+		tree[0].push_back(move(m));
+	}
+	while (tree.back().size() > 1) {
+		const vector<vector<double> >& below = tree.back();
+		vector<vector<double> > level;
+		for (size_t j = 0; j + 1 < below.size(); j += 2) {
+			level.push_back(Polynomial::productVec(below[j], below[j + 1]));
+		}
+		if (below.size() % 2) level.push_back(below.back());  // An unpaired node moves up as it is
+		tree.push_back(move(level));
+	}
+	return tree;
+}
+
+void Polynomial::multipointVec (const vector<double>& coef, const vector<double>& xs, const SubproductTree& tree, double* ys)
+{
+	vector<vector<double> > rems(1);
+	Polynomial::divideVec(coef, tree.back()[0], nullptr, &rems[0]);
+	for (size_t l = tree.size() - 1; l-- > 0;) {
+		vector<vector<double> > next(tree[l].size());
+		for (size_t j = 0; j < tree[l].size(); ++j) {
+			Polynomial::divideVec(rems[j / 2], tree[l][j], nullptr, &next[j]);
+		}
+		rems.swap(next);
+	}
+	for (size_t j = 0; j < rems.size(); ++j) {
+		const size_t start = j * Polynomial::treeLeaf;
+		const Polynomial leaf(move(rems[j]));
+		leaf.evaluate(xs.data() + start, ys + start, min(Polynomial::treeLeaf, xs.size() - start));
+	}
+}
+
+vector<double> Polynomial::evaluate (const vector<double>& xs, const bool tree) const
+{
+	vector<double> ys(xs.size());
+	if (!tree || xs.empty()) Polynomial::evaluate(xs.data(), ys.data(), xs.size());
+	else Polynomial::multipointVec(Polynomial::coefficients, xs, Polynomial::subproductTree(xs), ys.data());
+	return ys;
+}
+
+static void lejaOrder (vector<double>& xs, vector<double>& ys)  // Reorders both: the largest |x| first, then each the farthest from those before
+{
+	const size_t n = xs.size();
+	size_t best = 0;
+	for (size_t i = 1; i < n; ++i) {
+		if (abs(xs[i]) > abs(xs[best])) best = i;
+	}
+	vector<double> dist(n, 1.0);  // Product of distances to the points placed, scaled by the largest so it neither overflows nor underflows
+	for (size_t k = 0; k + 1 < n; ++k) {
+		swap(xs[k], xs[best]);
+		swap(ys[k], ys[best]);
+		swap(dist[k], dist[best]);
+		best = k + 1;
+		for (size_t i = k + 1; i < n; ++i) {
+			dist[i] *= abs(xs[i] - xs[k]);
+			if (dist[i] > dist[best]) best = i;
+		}
+		const double scale = dist[best];
+		if (scale > 0) {
+			for (size_t i = k + 1; i < n; ++i) dist[i] /= scale;
+		}
+	}
+}
+
+Polynomial Polynomial::interpolate (const vector<double>& xs, const vector<double>& ys, const bool tree)
+{
+	assert (!xs.empty() && xs.size() == ys.size());  // One value per point, and the points distinct
+	const size_t n = xs.size();
+	if (!tree) {
+		// Newton's divided differences on Leja-ordered points, in t = x / h with the points spanning 4 in t (so that the
+		// differences of rounding noise grow polynomially rather than like 2^j); err[i] estimates the rounding error of c[i],
+		// the errors of the two differences it comes from taken as independent
+		vector<double> x = xs, c = ys, err(n, 0.0);
+		lejaOrder(x, c);
+		const double h = (*max_element(x.begin(), x.end()) - *min_element(x.begin(), x.end())) / 4;
+		for (size_t j = 1; j < n; ++j) {
+			for (size_t i = n - 1; i >= j; --i) {
+				const double d = (x[i] - x[i - j]) / h, diff = c[i] - c[i - 1];
+				c[i] = diff / d;
+				err[i] = sqrt(err[i] * err[i] + err[i - 1] * err[i - 1] + eps * eps * diff * diff) / abs(d) + eps * abs(c[i]);
+			}
+		}
+		size_t m = n - 1;  // Drop the trailing differences that may be rounding alone, with a margin over the estimate
+		while (m > 0 && abs(c[m]) <= 4 * err[m]) m--;
+
+		// The Newton form multiplied out, each (t - t_k) as (x - x_k) / h
+		vector<double> p(1, c[m]);
+		for (size_t k = m; k-- > 0;) {  // p = p (x - x_k) / h + c_k
+			p.push_back(0);
+			for (size_t j = p.size() - 1; j > 0; --j) p[j] -= x[k] * p[j - 1];
+			for (double& a : p) a /= h;
+			p.back() += c[k];
+		}
+		return Polynomial(move(p));
+	}
+	const SubproductTree subproducts = Polynomial::subproductTree(xs);
+
+	// Lagrange weights y_i / M'(x_i), M the product of every (x - x_i), M' evaluated down the same tree
+	vector<double> w(n);
+	Polynomial::multipointVec(Polynomial(subproducts.back()[0]).derivativePoly().getCoefficients(), xs, subproducts, w.data());
+
+	// Leaves: the sum of w_i M_leaf / (x - x_i), each quotient by synthetic division
+	vector<vector<double> > sums(subproducts[0].size());
+	for (size_t j = 0; j < subproducts[0].size(); ++j) {
+		const vector<double>& m = subproducts[0][j];
+		sums[j].assign(m.size() - 1, 0.0);
+		for (size_t i = j * Polynomial::treeLeaf; i < min((j + 1) * Polynomial::treeLeaf, n); ++i) {
+			double c = 0;
+			for (size_t t = 0; t + 1 < m.size(); ++t) {
+				c = c * xs[i] + m[t];
+				sums[j][t] += ys[i] / w[i] * c;
+			}
+		}
+	}
+	// Up the tree: a node's sum is left * M_right + right * M_left
+	for (size_t l = 0; l + 1 < subproducts.size(); ++l) {
+		vector<vector<double> > next;
+		for (size_t j = 0; j + 1 < sums.size(); j += 2) {
+			vector<double> s = Polynomial::productVec(sums[j], subproducts[l][j + 1]);
+			addAligned(s, Polynomial::productVec(sums[j + 1], subproducts[l][j]));
+			next.push_back(move(s));
+		}
+		if (sums.size() % 2) next.push_back(move(sums.back()));
+		sums.swap(next);
+	}
+	return Polynomial(move(sums[0]));
+}
@@ -0,0 +1,163 @@
+#include <algorithm>  // func: std::min(), std::max(), std::count()
+#include <cmath>  // func: std::abs(), std::log(), std::exp(), std::cos(), std::sin(), std::pow()
+#include <cstddef>  // Type: size_t, ptrdiff_t
+#include <limits>  // func: std::numeric_limits<double>::epsilon(), infinity()
+#include <thread>  // Type: std::thread
+#include <vector>  // Type: std::vector
+
+#include "Polynomial.h"
+
+using namespace std;
+
+// All roots at once by the Aberth-Ehrlich iteration: every approximation z_i takes a Newton step deflated by the others,
+//   z_i -= N_i / (1 - N_i * sum_{j != i} 1/(z_i - z_j)),  N_i = p(z_i) / p'(z_i),
+// a sweep reading only the previous approximations, so the roots split across threads. Starting points come from the
+// Newton polygon of the coefficients (one circle per edge, as in Bini's MPSolve), and outside the unit circle p is
+// evaluated through its reversal at 1/z, so high degrees neither overflow nor lose the small roots. A root is done when
+// |p(z_i)| is below Horner's own rounding bound and it has taken polishSteps more steps there (the bound is pessimistic,
+// and ill-conditioned roots still gain digits from them); the sweep cap is only a safeguard.
+
+static const int sweepsMax = 1000;
+static const char polishSteps = 2;
+static const double eps = numeric_limits<double>::epsilon();
+
+struct RootStep  // One evaluation at z: the Newton correction p/p', and |p(z)| against its rounding bound
+{
+	Complex newton;
+	double logValue;  // log |p(z)|
+	double logBound;  // log of Horner's rounding bound for p(z)
+};
+
+static RootStep rootStep (const vector<double>& coef, const Complex& z)  // coef highest term first, no zero roots
+{
+	const size_t n = coef.size() - 1;
+	const double r = z.norm();
+	const bool inside = r <= 1;
+	const Complex w = inside ? z : z.reciprocal();
+	const double aw = w.norm();
+
+	// Horner for the value and derivative of p at z, or of the reversed polynomial at w = 1/z, on plain doubles
+	// (this is the O(n) inner loop of every step)
+	const double wr = w.re(), wi = w.im();
+	double pr = inside ? coef[0] : coef[n], pi = 0, dr = 0, di = 0;
+	double bound = abs(pr);
+	for (size_t k = 1; k <= n; ++k) {
+		const double c = inside ? coef[k] : coef[n - k];
+		const double t = dr * wr - di * wi + pr;
+		di = dr * wi + di * wr + pi;
+		dr = t;
+		const double u = pr * wr - pi * wi + c;
+		pi = pr * wi + pi * wr;
+		pr = u;
+		bound = bound * aw + abs(c);
+	}
+	const Complex p(pr, pi), d(dr, di);
+	RootStep step;
+	const double outside = inside ? 0 : double (n) * log(r);  // p(z) = z^n q(1/z)
+	step.logValue = log(p.norm()) + outside;
+	step.logBound = log(2 * double (n) * eps * bound) + outside;
+	if (inside) step.newton = p / d;
+	else step.newton = z / (Complex(double (n)) - w * d / p);  // p/p' = z / (n - w q'(w)/q(w))
+	return step;
+}
+
+template <class F>
+static void sweepChunks (const size_t n, int threads, F f)  // f(begin, end) over [0, n) in contiguous chunks
+{
+	if (threads <= 0) {
+		const unsigned hw = thread::hardware_concurrency();
+		threads = hw ? int (hw) : 1;
+	}
+	threads = int (min<size_t>(size_t (threads), max<size_t>(1, n / 64)));
+	const size_t chunk = (n + size_t (threads) - 1) / size_t (threads);
+	vector<thread> workers;
+	for (size_t start = chunk; start < n; start += chunk) {
+		workers.emplace_back(f, start, min(n, start + chunk));
+	}
+	f(0, min(chunk, n));
+	for (thread& t : workers) t.join();
+}
+
+vector<Complex> Polynomial::roots (vector<double>* radii, const int threads) const
+{
+	// Zero roots come off exactly; what is left has a non-zero constant term
+	size_t zeros = 0;
+	while (zeros < Polynomial::coefficients.size() - 1 && Polynomial::coefficients[Polynomial::coefficients.size() - 1 - zeros] == 0) zeros++;
+	const vector<double> coef(Polynomial::coefficients.begin(), Polynomial::coefficients.end() - zeros);
+	const size_t n = coef.size() - 1;
+
+	// Newton polygon: upper convex hull of (k, log|a_k|), a_k the coefficient of x^k
+	vector<size_t> hull;
+	auto height = [&](const size_t k) { return log(abs(coef[n - k])); };
+	for (size_t k = 0; k <= n; ++k) {
+		if (coef[n - k] == 0) continue;
+		while (hull.size() >= 2) {
+			const size_t a = hull[hull.size() - 2], b = hull.back();
+			if ((height(b) - height(a)) * double (k - a) > (height(k) - height(a)) * double (b - a)) break;
+			hull.pop_back();
+		}
+		hull.push_back(k);
+	}
+	vector<Complex> z;
+	for (size_t e = 1; e < hull.size(); ++e) {
+		const size_t m = hull[e] - hull[e - 1];
+		const double radius = exp((height(hull[e - 1]) - height(hull[e])) / double (m));
+		for (size_t j = 0; j < m; ++j) {
+			const double angle = 2 * M_PI * (double (j) / double (m) + double (hull[e - 1]) / double (n)) + 0.7;
+			z.push_back(Complex(radius * cos(angle), radius * sin(angle)));
+		}
+	}
+
+	// Aberth sweeps until every root is within rounding of a zero of p; polished[i] counts the steps taken there
+	vector<char> polished(n, 0);
+	vector<double> re(n), im(n);  // The O(n^2) sums run on plain doubles
+	for (int sweep = 0; sweep < sweepsMax; ++sweep) {
+		for (size_t i = 0; i < n; ++i) {
+			re[i] = z[i].re();
+			im[i] = z[i].im();
+		}
+		sweepChunks(n, threads, [&](const size_t begin, const size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				if (polished[i] > polishSteps) continue;
+				const RootStep step = rootStep(coef, z[i]);
+				if (step.logValue <= step.logBound) {
+					if (step.logValue == -numeric_limits<double>::infinity()) polished[i] = polishSteps;  // An exact zero needs no polish
+					if (++polished[i] > polishSteps) continue;
+				}
+				double sr = 0, si = 0;  // sum of 1/(z_i - z_j) = conj(z_i - z_j) / |z_i - z_j|^2
+				for (size_t j = 0; j < n; ++j) {
+					const double dr = re[i] - re[j], di = im[i] - im[j], q = dr * dr + di * di;
+					if (j != i) {
+						sr += dr / q;
+						si -= di / q;
+					}
+				}
+				z[i] -= step.newton / (Complex(1) - step.newton * Complex(sr, si));
+			}
+		});
+		if (count(polished.begin(), polished.end(), polishSteps + 1) == ptrdiff_t (n)) break;
+	}
+
+	// Inclusion radii n |p(z_i)| / |a_n prod_{j != i} (z_i - z_j)|: the discs hold every root, an isolated one exactly one.
+	// |p(z_i)| counts at least its rounding bound, so the discs also cover the error of evaluating p
+	if (radii) {
+		for (size_t i = 0; i < n; ++i) {
+			re[i] = z[i].re();
+			im[i] = z[i].im();
+		}
+		radii->assign(n + zeros, 0.0);
+		sweepChunks(n, threads, [&](const size_t begin, const size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				const RootStep step = rootStep(coef, z[i]);
+				double logRadius = log(double (n)) + max(step.logValue, step.logBound) - log(abs(coef[0]));
+				for (size_t j = 0; j < n; ++j) {
+					const double dr = re[i] - re[j], di = im[i] - im[j];
+					if (j != i) logRadius -= 0.5 * log(dr * dr + di * di);
+				}
+				(*radii)[i] = exp(logRadius);
+			}
+		});
+	}
+	z.resize(n + zeros, Complex(0));
+	return z;
+}
@@ -0,0 +1,205 @@
+#include <algorithm>  // func: std::sort()
+#include <cmath>  // func: std::abs()
+#include <cstddef>  // Type: size_t
+#include <limits>  // func: std::numeric_limits<double>::epsilon()
+#include <queue>  // Type: std::priority_queue
+#include <utility>  // func: std::move()
+#include <vector>  // Type: std::vector
+
+#include "SparsePolynomial.h"
+
+using namespace std;
+
+// Products: the terms of a*b come out of a max-heap holding one cursor per term of the shorter factor (Johnson's
+// method), so equal exponents meet consecutively and the product is built already sorted, in O(ta tb log ta) time and
+// O(ta) extra memory. The dense engine costs about as much per coefficient of the product as the heap does per pair of
+// terms, so sparseProduct() picks the heap while terms1 * terms2 <= size1 + size2, that is while the fill ratios have
+// fill1 * fill2 <= 1/size1 + 1/size2 (measured at -O2). Both classes multiply through it, whichever form they store.
+// Only the algorithm adapts: a Polynomial always stores every coefficient and a SparsePolynomial only its terms, and
+// neither changes form by itself (convert with SparsePolynomial(poly) and toPolynomial()).
+
+const double SparsePolynomial::sparseWork = 1.0;
+
+SparsePolynomial::SparsePolynomial ()
+{
+	SparsePolynomial::terms.push_back(Term(0, 1.0));
+}
+
+SparsePolynomial::SparsePolynomial (vector<Term> terms)
+{
+	SparsePolynomial::terms = move(terms);
+	SparsePolynomial::normalize();
+}
+
+SparsePolynomial::SparsePolynomial (const Polynomial& poly)
+{
+	SparsePolynomial::terms = SparsePolynomial::termsOf(poly.getCoefficients());
+}
+
+Polynomial SparsePolynomial::toPolynomial () const
+{
+	return Polynomial(SparsePolynomial::coefficientsOf(SparsePolynomial::terms, SparsePolynomial::getDegree() + 1));
+}
+
+vector<SparsePolynomial::Term> SparsePolynomial::termsOf (const vector<double>& coef, const double below)
+{
+	vector<Term> terms;
+	for (size_t i = 0; i < coef.size(); ++i) {
+		if (abs(coef[i]) > below) terms.push_back(Term(coef.size() - 1 - i, coef[i]));
+	}
+	return terms;
+}
+
+vector<double> SparsePolynomial::coefficientsOf (const vector<Term>& terms, const size_t size)
+{
+	vector<double> coef(size, 0.0);
+	for (const Term& t : terms) coef[size - 1 - t.first] = t.second;
+	return coef;
+}
+
+const vector<SparsePolynomial::Term>& SparsePolynomial::getTerms () const
+{
+	return SparsePolynomial::terms;
+}
+
+size_t SparsePolynomial::getDegree () const
+{
+	return SparsePolynomial::terms.empty() ? 0 : SparsePolynomial::terms[0].first;
+}
+
+double SparsePolynomial::norm1 () const
+{
+	double sum = 0;
+	for (const Term& t : SparsePolynomial::terms) sum += abs(t.second);
+	return sum;
+}
+
+double SparsePolynomial::fillRatio () const
+{
+	return double (SparsePolynomial::terms.size()) / double (SparsePolynomial::getDegree() + 1);
+}
+
+void SparsePolynomial::normalize ()
+{
+	sort(SparsePolynomial::terms.begin(), SparsePolynomial::terms.end(), [](const Term& a, const Term& b) { return a.first > b.first; });
+	size_t out = 0;
+	for (size_t i = 0; i < SparsePolynomial::terms.size();) {
+		Term t = SparsePolynomial::terms[i++];
+		while (i < SparsePolynomial::terms.size() && SparsePolynomial::terms[i].first == t.first) t.second += SparsePolynomial::terms[i++].second;
+		if (t.second != 0) SparsePolynomial::terms[out++] = t;
+	}
+	SparsePolynomial::terms.resize(out);
+}
+
+bool SparsePolynomial::equals (const SparsePolynomial& poly) const
+{
+	return SparsePolynomial::terms == poly.terms;
+}
+
+SparsePolynomial& SparsePolynomial::add (const SparsePolynomial& poly)
+{
+	// Merge of two sorted lists
+	vector<Term> sum;
+	sum.reserve(SparsePolynomial::terms.size() + poly.terms.size());
+	size_t i = 0, j = 0;
+	while (i < SparsePolynomial::terms.size() || j < poly.terms.size()) {
+		if (j == poly.terms.size() || (i < SparsePolynomial::terms.size() && SparsePolynomial::terms[i].first > poly.terms[j].first)) sum.push_back(SparsePolynomial::terms[i++]);
+		else if (i == SparsePolynomial::terms.size() || poly.terms[j].first > SparsePolynomial::terms[i].first) sum.push_back(poly.terms[j++]);
+		else {
+			const double c = SparsePolynomial::terms[i++].second + poly.terms[j].second;
+			if (c != 0) sum.push_back(Term(poly.terms[j].first, c));
+			j++;
+		}
+	}
+	SparsePolynomial::terms.swap(sum);
+	return *this;
+}
+
+SparsePolynomial& SparsePolynomial::subtract (const SparsePolynomial& poly)
+{
+	SparsePolynomial negative(poly);
+	return SparsePolynomial::add(negative.scalarMultiply(-1));
+}
+
+SparsePolynomial& SparsePolynomial::multiply (const SparsePolynomial& poly)
+{
+	if (SparsePolynomial::terms.empty() || poly.terms.empty()) {
+		SparsePolynomial::terms.clear();
+		return *this;
+	}
+	const size_t size1 = SparsePolynomial::getDegree() + 1, size2 = poly.getDegree() + 1;
+	if (SparsePolynomial::sparseProduct(SparsePolynomial::terms.size(), size1, poly.terms.size(), size2)) {
+		SparsePolynomial::terms = SparsePolynomial::productTerms(SparsePolynomial::terms, poly.terms);
+	}
+	else {
+		// Dense enough that the dense engine wins; its vectors are no longer than the heap's work. Its rounding (FFT or
+		// Karatsuba) leaves noise at exponents no pair of terms reaches, below eps |a|_1 |b|_1, so that much is dropped
+		const vector<double> product = Polynomial::productVec(SparsePolynomial::coefficientsOf(SparsePolynomial::terms, size1), SparsePolynomial::coefficientsOf(poly.terms, size2));
+		SparsePolynomial::terms = SparsePolynomial::termsOf(product, numeric_limits<double>::epsilon() * SparsePolynomial::norm1() * poly.norm1());
+	}
+	return *this;
+}
+
+SparsePolynomial& SparsePolynomial::scalarMultiply (const double k)
+{
+	if (k == 0) SparsePolynomial::terms.clear();
+	for (Term& t : SparsePolynomial::terms) t.second *= k;
+	return *this;
+}
+
+vector<SparsePolynomial::Term> SparsePolynomial::productTerms (const vector<Term>& a, const vector<Term>& b)
+{
+	if (a.size() > b.size()) return SparsePolynomial::productTerms(b, a);
+	vector<Term> product;
+	if (a.empty()) return product;
+
+	// Cursor i stands at b[j[i]], its key the exponent of a[i] * b[j[i]]; row i enters once row i - 1 has moved on,
+	// since until then its products are all smaller
+	struct Cursor
+	{
+		size_t exponent, i, j;
+		bool operator < (const Cursor& c) const { return exponent < c.exponent; }
+	};
+	priority_queue<Cursor> heap;
+	heap.push(Cursor{a[0].first + b[0].first, 0, 0});
+	while (!heap.empty()) {
+		Cursor c = heap.top();
+		heap.pop();
+		const double value = a[c.i].second * b[c.j].second;
+		if (!product.empty() && product.back().first == c.exponent) product.back().second += value;
+		else {
+			if (!product.empty() && product.back().second == 0) product.pop_back();
+			product.push_back(Term(c.exponent, value));
+		}
+		if (c.j == 0 && c.i + 1 < a.size()) heap.push(Cursor{a[c.i + 1].first + b[0].first, c.i + 1, 0});
+		if (c.j + 1 < b.size()) heap.push(Cursor{a[c.i].first + b[c.j + 1].first, c.i, c.j + 1});
+	}
+	if (!product.empty() && product.back().second == 0) product.pop_back();
+	return product;
+}
+
+bool SparsePolynomial::sparseProduct (const size_t terms1, const size_t size1, const size_t terms2, const size_t size2)
+{
+	return double (terms1) * double (terms2) <= SparsePolynomial::sparseWork * double (size1 + size2);
+}
+
+double SparsePolynomial::powBySquaring (double x, size_t n)
+{
+	double y = 1;
+	for (; n; n >>= 1) {
+		if (n & 1) y *= x;
+		x *= x;
+	}
+	return y;
+}
+
+double SparsePolynomial::evaluate (double x) const
+{
+	// Horner with gaps: y = y x^(e_k - e_(k+1)) + c_(k+1), then the trailing power of the lowest term
+	if (SparsePolynomial::terms.empty()) return 0;
+	double y = SparsePolynomial::terms[0].second;
+	for (size_t k = 1; k < SparsePolynomial::terms.size(); ++k) {
+		y = y * SparsePolynomial::powBySquaring(x, SparsePolynomial::terms[k - 1].first - SparsePolynomial::terms[k].first) + SparsePolynomial::terms[k].second;
+	}
+	return y * SparsePolynomial::powBySquaring(x, SparsePolynomial::terms.back().first);
+}
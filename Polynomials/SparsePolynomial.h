@@ -0,0 +1,68 @@
+#ifndef SPARSEPOLYNOMIAL_H
+#define SPARSEPOLYNOMIAL_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Polynomial.h"
+
+// A polynomial kept as its non-zero terms only, so x^1000000 + 1 costs two terms of memory and work.
+// Products switch to the dense engine (Polynomial::productVec) when the factors are dense enough to make that faster;
+// the result is stored sparse all the same.
+class SparsePolynomial
+{
+	public:
+		typedef std::pair<size_t, double> Term;  // (exponent, coefficient)
+
+	private:
+		std::vector<Term> terms;  // Non-zero terms, highest exponent first; the null polynomial has none
+
+		void normalize ();  // Sorts, merges equal exponents and drops zero terms
+		static double powBySquaring (double x, size_t n);
+
+	public:
+		static const double sparseWork;  // Term products the heap may spend per coefficient of the dense product
+
+		SparsePolynomial ();  // Unit polynomial, as Polynomial
+		SparsePolynomial (std::vector<Term> terms);  // In any order; terms with the same exponent add up
+		SparsePolynomial (const Polynomial& poly);  // Dense to sparse: keeps the non-zero coefficients
+		Polynomial toPolynomial () const;  // Sparse to dense: degree + 1 coefficients
+		const std::vector<Term>& getTerms () const;
+		size_t getDegree () const;
+		size_t termCount () const { return terms.size(); }
+		double fillRatio () const;  // termCount / (degree + 1)
+		double norm1 () const;  // Sum of |coefficient|
+		bool isNull () const { return terms.empty(); }
+
+		// Operations
+		bool equals (const SparsePolynomial& poly) const;
+		SparsePolynomial& add (const SparsePolynomial& poly);
+		SparsePolynomial& subtract (const SparsePolynomial& poly);
+		SparsePolynomial& multiply (const SparsePolynomial& poly);
+		SparsePolynomial& scalarMultiply (const double k);
+
+		// Operators
+		bool operator == ( const SparsePolynomial& poly ) const { return equals(poly); }  // Binary Comparison (==)
+		bool operator != ( const SparsePolynomial& poly ) const { return !equals(poly); }  // Binary Comparison (!=)
+		SparsePolynomial& operator += ( const SparsePolynomial& poly ) { return add(poly); }  // Assignment (+=)
+		SparsePolynomial& operator -= ( const SparsePolynomial& poly ) { return subtract(poly); }  // Assignment (-=)
+		SparsePolynomial& operator *= ( const SparsePolynomial& poly ) { return multiply(poly); }  // Assignment (*=)
+		SparsePolynomial& operator *= ( const double k ) { return scalarMultiply(k); }  // Assignment (*=)
+
+		// Calculations
+		double evaluate (double x) const;  // Horner across the gaps, each power by squaring: O(terms log degree)
+
+		static std::vector<Term> productTerms (const std::vector<Term>& a, const std::vector<Term>& b);  // Heap merge of the term products, highest first
+		static bool sparseProduct (size_t terms1, size_t size1, size_t terms2, size_t size2);  // terms1 * terms2 <= sparseWork * (size1 + size2)
+		static std::vector<Term> termsOf (const std::vector<double>& coef, double below = 0);  // Coefficients of a highest-first vector with |c| > below
+		static std::vector<double> coefficientsOf (const std::vector<Term>& terms, size_t size);  // Highest-first vector of size terms (> degree)
+};
+
+inline SparsePolynomial operator + ( SparsePolynomial a, const SparsePolynomial& b ) { a.add(b); return a; }  // Binary (+)
+inline SparsePolynomial operator - ( SparsePolynomial a, const SparsePolynomial& b ) { a.subtract(b); return a; }  // Binary (-)
+inline SparsePolynomial operator * ( SparsePolynomial a, const SparsePolynomial& b ) { a.multiply(b); return a; }  // Binary (*)
+inline SparsePolynomial operator * ( SparsePolynomial a, const double k ) { a.scalarMultiply(k); return a; }  // Binary (*) Scalar
+inline SparsePolynomial operator * ( const double k, SparsePolynomial a ) { a.scalarMultiply(k); return a; }  // Binary (*) Scalar
+
+#endif
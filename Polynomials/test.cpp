@@ -1,7 +1,10 @@
 #include <iostream>
 #include <string>
 #include <iomanip>
+#include <cmath>
 #include "Polynomial.h"
+#include "SparsePolynomial.h"
+#include "FixedPolynomial.h"
 
 using namespace std;
 
@@ -32,5 +35,56 @@ int main () {
 
 	printVec((x - y).getCoefficients());
 
+	Polynomial q, r;
+	x.divmod(Polynomial({1, 0, 1}), q, r);
+	printVec(q.getCoefficients());
+	printVec(r.getCoefficients());
+	printVec((x / y).getCoefficients());
+	printVec(Polynomial::gcd(x, Polynomial({1, 0, -4})).getCoefficients());  // x = (x^2 + 3)(2x + 1) shares no factor with x^2 - 4: 1
+	printVec(Polynomial::gcd(x * Polynomial({1, -1}), Polynomial({1, 0, -1})).getCoefficients());  // x - 1
+
+	vector<double> radii;
+	vector<Complex> roots = x.roots(&radii);  // -0.5 and +-1.732i
+	for (size_t i = 0; i < roots.size(); ++i) {
+		cout << roots[i].re() << " " << roots[i].im() << "i (radius " << radii[i] << ")" << endl;
+	}
+
+	SparsePolynomial s({{1000000, 1}, {0, 1}});  // x^1000000 + 1
+	s *= s;
+	cout << s.termCount() << " terms, degree " << s.getDegree() << ", s(1) = " << s.evaluate(1) << endl;  // 3 terms, degree 2000000, s(1) = 4
+	vector<SparsePolynomial::Term> spaced;
+	for (size_t e = 0; e <= 1000000; e += 500) spaced.push_back(SparsePolynomial::Term(e, 1));
+	SparsePolynomial comb(spaced);
+	comb *= comb;  // Dense engine: 2001^2 term products against 2 * 1000001 coefficients
+	cout << comb.termCount() << " terms, comb(1) = " << comb.evaluate(1) << endl;  // 4001 terms, comb(1) = 4.004e+06
+
+	constexpr FixedPolynomial<double, 2> f{1, 0, 3};  // x^2 + 3, as x before the product
+	static_assert((f * FixedPolynomial<double, 1>{2, 1}).evaluate(1) == 12, "constexpr product");
+	Polynomial g = y + f * 2;
+	printVec(g.getCoefficients());  // 2 2 7
+
+	vector<double> nodes(600), values(600);
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		nodes[i] = cos(M_PI * (i + 0.5) / nodes.size());  // Chebyshev points
+		values[i] = 3 * nodes[i] * nodes[i] - nodes[i] + 2;
+	}
+	for (size_t n : {100, 600}) {
+		const vector<double> xs(nodes.begin(), nodes.begin() + n), ys(values.begin(), values.begin() + n);
+		const Polynomial p = Polynomial::interpolate(xs, ys);
+		double error = 0;
+		for (size_t i = 0; i < n; ++i) error = max(error, abs(p.evaluate(xs[i]) - ys[i]));
+		cout << "interpolate " << n << " points: degree " << p.getDegree() << ", node error " << (error < 1e-13 ? "< 1e-13" : to_string(error)) << endl;  // degree 2, < 1e-13
+	}
+
+	vector<double> big(4096), points(4096);
+	for (size_t i = 0; i < big.size(); ++i) {
+		big[i] = sin(double (i));
+		points[i] = 2 * sin(1.7 * double (i)) / sqrt(double (points.size()));  // The tree keeps its digits within a few 1/sqrt(n) of 0
+	}
+	const vector<double> viaTree = Polynomial(big).evaluate(points, true), direct = Polynomial(big).evaluate(points);
+	double treeError = 0;
+	for (size_t i = 0; i < points.size(); ++i) treeError = max(treeError, abs(viaTree[i] - direct[i]) / (1 + abs(direct[i])));
+	cout << "tree evaluation at 4096 points: error " << (treeError < 1e-12 ? "< 1e-12" : to_string(treeError)) << endl;  // < 1e-12
+
 	return 0;
 }
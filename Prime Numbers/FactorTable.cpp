@@ -0,0 +1,46 @@
+#include <cstdint>  // Type: uint32_t, uint64_t
+#include <vector>  // Type: std::vector
+
+#include "FactorTable.h"
+
+using namespace std;
+
+FactorTable::FactorTable ()
+{
+	FactorTable::bound = 0;
+	FactorTable::oddOnly = false;
+}
+
+FactorTable::FactorTable (const uint32_t bound, const bool oddOnly)
+{
+	FactorTable::bound = bound;
+	FactorTable::oddOnly = oddOnly;
+
+	// Linear sieve: every composite i*p is written exactly once, by its smallest prime p <= spf(i)
+	vector<uint32_t> primes;
+	if (!oddOnly) {
+		FactorTable::spf.assign(uint64_t (bound) + 1, 0);
+		for (uint64_t i = 2; i <= bound; ++i) {
+			if (FactorTable::spf[i] == 0) {
+				FactorTable::spf[i] = uint32_t (i);
+				primes.push_back(uint32_t (i));
+			}
+			for (size_t k = 0; k < primes.size() && primes[k] <= FactorTable::spf[i] && i * primes[k] <= bound; ++k) {
+				FactorTable::spf[i * primes[k]] = primes[k];
+			}
+		}
+	} else {
+		// Odd numbers only: an odd composite is an odd i times an odd prime, so even numbers never take part
+		FactorTable::spf.assign(uint64_t (bound) / 2 + 1, 0);
+		FactorTable::spf[0] = 1;
+		for (uint64_t i = 3; i <= bound; i += 2) {
+			if (FactorTable::spf[i / 2] == 0) {
+				FactorTable::spf[i / 2] = uint32_t (i);
+				primes.push_back(uint32_t (i));
+			}
+			for (size_t k = 0; k < primes.size() && primes[k] <= FactorTable::spf[i / 2] && i * primes[k] <= bound; ++k) {
+				FactorTable::spf[i * primes[k] / 2] = primes[k];
+			}
+		}
+	}
+}
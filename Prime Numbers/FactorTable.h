@@ -0,0 +1,28 @@
+#ifndef FACTORTABLE_H
+#define FACTORTABLE_H
+
+#include <cstdint>
+#include <vector>
+
+class FactorTable  // Smallest prime factor of every number up to a bound, built by a linear sieve
+{
+	private:
+		std::vector<uint32_t> spf;  // spf[i] = smallest prime factor of i (of 2i+1 when odd only)
+		uint32_t bound;
+		bool oddOnly;  // Only odd numbers are stored, halving the memory
+
+	public:
+		FactorTable ();  // Empty table, covers nothing
+		FactorTable (const uint32_t bound, const bool oddOnly = false);  // O(bound) time, 4 bytes per entry
+		bool covers (const uint64_t n) const { return n <= bound && !spf.empty(); }
+		uint32_t getBound () const { return bound; }
+		uint32_t smallestFactor (const uint32_t n) const;  // n must be covered and > 1
+};
+
+inline uint32_t FactorTable::smallestFactor (const uint32_t n) const
+{
+	if (!oddOnly) return spf[n];
+	return n % 2 == 0 ? 2 : spf[n / 2];
+}
+
+#endif
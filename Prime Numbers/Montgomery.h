@@ -0,0 +1,72 @@
+#ifndef MONTGOMERY_H
+#define MONTGOMERY_H
+
+#include <cstdint>
+
+class Montgomery  // Montgomery arithmetic modulo an odd 64-bit n, R = 2^64 (values kept in [0, n))
+{
+	private:
+		uint64_t n;  // Modulus (odd)
+		uint64_t inv;  // n^-1 mod 2^64
+		uint64_t r1;  // R mod n, the Montgomery form of 1
+		uint64_t r2;  // R^2 mod n, converts into Montgomery form
+
+	public:
+		explicit Montgomery (const uint64_t n);
+
+		uint64_t modulus () const { return n; }
+		uint64_t one () const { return r1; }
+		uint64_t reduce (const unsigned __int128 t) const;  // t * R^-1 mod n, for t < n * 2^64
+		uint64_t multiply (const uint64_t a, const uint64_t b) const { return reduce((unsigned __int128) a * b); }
+		uint64_t add (const uint64_t a, const uint64_t b) const { return a >= n - b ? a - (n - b) : a + b; }
+		uint64_t subtract (const uint64_t a, const uint64_t b) const { return a >= b ? a - b : a + (n - b); }
+		uint64_t half (const uint64_t a) const { return a & 1 ? (a >> 1) + (n >> 1) + 1 : a >> 1; }  // a/2 mod n, same in either form
+		uint64_t toForm (const uint64_t a) const { return multiply(a % n, r2); }
+		uint64_t fromForm (const uint64_t a) const { return reduce(a); }
+		uint64_t power (uint64_t a, uint64_t e) const;  // a^e with a (and the result) in Montgomery form
+		uint64_t powerOfTwo (const uint64_t e) const;  // 2^e in Montgomery form, doubling instead of multiplying by the base
+};
+
+inline Montgomery::Montgomery (const uint64_t n)
+{
+	Montgomery::n = n;
+	uint64_t x = n;  // Correct to 3 bits for odd n; each Newton step doubles that
+	for (int i = 0; i < 5; ++i) x *= 2 - n * x;
+	Montgomery::inv = x;
+	Montgomery::r1 = (0 - n) % n;
+	Montgomery::r2 = uint64_t ((unsigned __int128) Montgomery::r1 * Montgomery::r1 % n);
+}
+
+inline uint64_t Montgomery::reduce (const unsigned __int128 t) const
+{
+	// m*n agrees with t in the low 64 bits, so (t - m*n) / R is just the difference of the high words
+	const uint64_t m = uint64_t (t) * inv;
+	const uint64_t hi = uint64_t (t >> 64), mn = uint64_t (((unsigned __int128) m * n) >> 64);
+	return hi >= mn ? hi - mn : hi - mn + n;
+}
+
+inline uint64_t Montgomery::power (uint64_t a, uint64_t e) const
+{
+	uint64_t result = r1;
+	while (e) {
+		if (e & 1) result = multiply(result, a);
+		a = multiply(a, a);
+		e >>= 1;
+	}
+	return result;
+}
+
+inline uint64_t Montgomery::powerOfTwo (const uint64_t e) const
+{
+	// Left to right: a square per bit, then a doubling on a set bit. The bit picks by mask, as a branch on it would
+	// mispredict half the time
+	uint64_t x = r1;
+	for (int bit = 63 - __builtin_clzll(e | 1); bit >= 0; --bit) {
+		x = multiply(x, x);
+		const uint64_t mask = 0 - ((e >> bit) & 1);
+		x = (add(x, x) & mask) | (x & ~mask);
+	}
+	return x;
+}
+
+#endif
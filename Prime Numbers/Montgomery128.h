@@ -0,0 +1,84 @@
+#ifndef MONTGOMERY128_H
+#define MONTGOMERY128_H
+
+#include <cstdint>
+
+class Montgomery128  // Montgomery arithmetic modulo an odd 128-bit n, R = 2^128 (values kept in [0, n))
+{
+	private:
+		typedef unsigned __int128 u128;
+		u128 n;  // Modulus (odd)
+		u128 inv;  // n^-1 mod 2^128
+		u128 r1;  // R mod n, the Montgomery form of 1
+
+	public:
+		explicit Montgomery128 (const u128 n);
+
+		static void multiplyFull (const u128 a, const u128 b, u128& hi, u128& lo);  // 256-bit product from four 64-bit ones
+		u128 modulus () const { return n; }
+		u128 one () const { return r1; }
+		u128 reduce (const u128 hi, const u128 lo) const;  // (hi*2^128 + lo) * R^-1 mod n, for hi < n
+		u128 multiply (const u128 a, const u128 b) const;
+		u128 add (const u128 a, const u128 b) const { return a >= n - b ? a - (n - b) : a + b; }
+		u128 subtract (const u128 a, const u128 b) const { return a >= b ? a - b : a + (n - b); }
+		u128 half (const u128 a) const { return a & 1 ? (a >> 1) + (n >> 1) + 1 : a >> 1; }  // a/2 mod n, same in either form
+		u128 small (uint64_t k) const;  // Montgomery form of a small k, by doubling R mod n (no R^2 mod n needed)
+		u128 fromForm (const u128 a) const { return reduce(0, a); }
+		u128 power (u128 a, u128 e) const;  // a^e with a (and the result) in Montgomery form
+};
+
+inline Montgomery128::Montgomery128 (const u128 n)
+{
+	Montgomery128::n = n;
+	u128 x = n;  // Correct to 3 bits for odd n; each Newton step doubles that
+	for (int i = 0; i < 6; ++i) x *= 2 - n * x;
+	Montgomery128::inv = x;
+	Montgomery128::r1 = (0 - n) % n;
+}
+
+inline void Montgomery128::multiplyFull (const u128 a, const u128 b, u128& hi, u128& lo)
+{
+	const uint64_t a0 = uint64_t (a), a1 = uint64_t (a >> 64), b0 = uint64_t (b), b1 = uint64_t (b >> 64);
+	const u128 p00 = (u128) a0 * b0, p01 = (u128) a0 * b1, p10 = (u128) a1 * b0, p11 = (u128) a1 * b1;
+	const u128 mid = (p00 >> 64) + uint64_t (p01) + uint64_t (p10);
+	lo = (mid << 64) | uint64_t (p00);
+	hi = p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+}
+
+inline unsigned __int128 Montgomery128::reduce (const u128 hi, const u128 lo) const
+{
+	// m*n agrees with the input in the low 128 bits, so the result is just the difference of the high halves
+	u128 mnHi, mnLo;
+	Montgomery128::multiplyFull(lo * inv, n, mnHi, mnLo);
+	return hi >= mnHi ? hi - mnHi : hi - mnHi + n;
+}
+
+inline unsigned __int128 Montgomery128::multiply (const u128 a, const u128 b) const
+{
+	u128 hi, lo;
+	Montgomery128::multiplyFull(a, b, hi, lo);
+	return reduce(hi, lo);
+}
+
+inline unsigned __int128 Montgomery128::small (uint64_t k) const
+{
+	u128 result = 0, x = r1;
+	for (; k; k >>= 1) {
+		if (k & 1) result = add(result, x);
+		x = add(x, x);
+	}
+	return result;
+}
+
+inline unsigned __int128 Montgomery128::power (u128 a, u128 e) const
+{
+	u128 result = r1;
+	while (e) {
+		if (e & 1) result = multiply(result, a);
+		a = multiply(a, a);
+		e >>= 1;
+	}
+	return result;
+}
+
+#endif
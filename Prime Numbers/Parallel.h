@@ -0,0 +1,114 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+class Parallel  // [Static] Namespace Class (No Instantiation)
+{
+	private:
+		struct Queue  // Contiguous block of task indices [next, end) owned by one worker
+		{
+			std::mutex lock;
+			long next = 0;
+			long end = 0;
+		};
+
+		static bool take (Queue& q, long& task);  // Pops the front of a worker's own queue
+		static bool steal (Queue& victim, Queue& own);  // Moves the back half of victim into own
+
+	public:
+		static int threadCount (const int threads);  // threads <= 0 means every hardware thread
+		template <class F> static void forRange (const long tasks, const int threads, F f);  // Calls f(task, worker) for task in [0, tasks); rethrows the first exception of f
+};
+
+inline int Parallel::threadCount (const int threads)
+{
+	if (threads > 0) return threads;
+	unsigned hw = std::thread::hardware_concurrency();
+	return hw ? int (hw) : 1;
+}
+
+inline bool Parallel::take (Queue& q, long& task)
+{
+	std::lock_guard<std::mutex> guard(q.lock);
+	if (q.next >= q.end) return false;
+	task = q.next++;
+	return true;
+}
+
+inline bool Parallel::steal (Queue& victim, Queue& own)
+{
+	long from, to;
+	{
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (victim.next >= victim.end) return false;
+		from = victim.next + (victim.end - victim.next) / 2;
+		to = victim.end;
+		victim.end = from;
+	}
+	std::lock_guard<std::mutex> guard(own.lock);
+	own.next = from;
+	own.end = to;
+	return true;
+}
+
+// Every worker starts with an equal block of tasks and takes from its front; a worker that runs dry
+// steals the back half of another worker's block, so uneven tasks still balance out. A thread that fails to start
+// leaves its block to be stolen, and an exception in a worker is rethrown on the caller once every thread has joined.
+template <class F>
+void Parallel::forRange (const long tasks, const int threads, F f)
+{
+	const int workers = int (std::min<long>(Parallel::threadCount(threads), std::max(tasks, 1L)));
+	if (workers <= 1) {
+		for (long t = 0; t < tasks; ++t) f(t, 0);
+		return;
+	}
+
+	std::unique_ptr<Queue[]> queues(new Queue[workers]);
+	for (int w = 0; w < workers; ++w) {
+		queues[w].next = tasks * w / workers;
+		queues[w].end = tasks * (w + 1) / workers;
+	}
+
+	std::exception_ptr failure;
+	std::mutex failureLock;
+	auto work = [&](int w) {
+		try {
+			long task;
+			for (;;) {
+				while (Parallel::take(queues[w], task)) f(task, w);
+				bool stolen = false;
+				for (int v = 1; v < workers && !stolen; ++v) {
+					stolen = Parallel::steal(queues[(w + v) % workers], queues[w]);
+				}
+				if (!stolen) return;  // No work is ever added, so empty queues everywhere means done
+			}
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> guard(failureLock);
+			if (!failure) failure = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> pool;
+	pool.reserve(workers - 1);
+	for (int w = 1; w < workers; ++w) {
+		try {
+			pool.emplace_back(work, w);
+		}
+		catch (const std::system_error&) {
+			break;  // Out of threads: the ones running steal the rest
+		}
+	}
+	work(0);
+	for (std::thread& t : pool) t.join();
+	if (failure) std::rethrow_exception(failure);
+}
+
+#endif
@@ -0,0 +1,147 @@
+#include <algorithm>  // func: std::upper_bound(), std::max()
+#include <cstdint>  // Type: uint64_t
+#include <cstdio>  // func: std::fopen(), std::fread(), std::fwrite(), std::rename()
+#include <cstring>  // func: std::memcpy(), std::memcmp(), std::memset()
+#include <string>  // Type: std::string
+#include <vector>  // Type: std::vector
+
+#include "Parallel.h"
+#include "PiIndex.h"
+#include "Sieve.h"
+
+using namespace std;
+
+static const char indexMagic[8] = {'P', 'R', 'M', 'P', 'I', 'I', 'D', 'X'};
+
+PiIndex::PiIndex ()
+{
+	PiIndex::stride = PiIndex::defaultStride;
+	PiIndex::bound = 0;
+}
+
+bool PiIndex::open (const string& path)
+{
+	PiIndex::close();
+	FILE* f = fopen(path.c_str(), "rb");
+	if (f == nullptr) {
+		return false;
+	}
+	Header h;
+	bool ok = fread(&h, sizeof(h), 1, f) == 1 && memcmp(h.magic, indexMagic, sizeof(indexMagic)) == 0
+		&& h.version == PiIndex::version && h.stride > 0 && h.stride % 2 == 0 && h.bound % h.stride == 0
+		&& h.entries == h.bound / h.stride + 1;
+	vector<uint64_t> c;
+	if (ok) {
+		c.resize(h.entries);
+		ok = fread(c.data(), sizeof(uint64_t), c.size(), f) == c.size() && fgetc(f) == EOF;
+	}
+	fclose(f);
+	if (!ok) {
+		return false;
+	}
+	PiIndex::counts.swap(c);
+	PiIndex::stride = h.stride;
+	PiIndex::bound = h.bound;
+	return true;
+}
+
+void PiIndex::close ()
+{
+	PiIndex::counts.clear();
+	PiIndex::stride = PiIndex::defaultStride;
+	PiIndex::bound = 0;
+}
+
+long PiIndex::pi (const long n) const
+{
+	if (n < 2) {
+		return 0;
+	}
+	// counts[j] covers [0, j*stride); sieve whichever side of n is shorter
+	const uint64_t j = uint64_t (n) / PiIndex::stride;
+	const long below = long (j * PiIndex::stride), above = long ((j + 1) * PiIndex::stride);
+	Sieve sieve(above - 1, true);
+	if (n - below < above - 1 - n) {
+		return long (PiIndex::counts[j]) + sieve.count(below, n);
+	}
+	return long (PiIndex::counts[j + 1]) - sieve.count(n + 1, above - 1);
+}
+
+long PiIndex::count (const long lo, const long hi) const
+{
+	if (hi < 2 || hi < lo) {
+		return 0;
+	}
+	// Within one stride (or nearly), sieving the range itself is the cheaper option
+	if (hi - lo < long (PiIndex::stride)) {
+		return Sieve(hi, true).count(lo, hi);
+	}
+	return PiIndex::pi(hi) - PiIndex::pi(lo - 1);
+}
+
+long PiIndex::nthPrime (const long k) const
+{
+	if (k < 1 || PiIndex::counts.empty() || uint64_t (k) > PiIndex::counts.back()) {
+		return 0;
+	}
+	// The stride j with counts[j] < k <= counts[j+1] holds it; walk in from its nearer end
+	const uint64_t j = uint64_t (upper_bound(PiIndex::counts.begin(), PiIndex::counts.end(), uint64_t (k) - 1) - PiIndex::counts.begin()) - 1;
+	const long below = long (j * PiIndex::stride), above = long ((j + 1) * PiIndex::stride);
+	Sieve sieve(above - 1, true);
+	const long fromBelow = k - long (PiIndex::counts[j]), fromAbove = long (PiIndex::counts[j + 1]) - k + 1;
+	if (fromBelow <= fromAbove) {
+		return sieve.nth(below - 1, fromBelow);
+	}
+	return sieve.nth(above - 1, -fromAbove);
+}
+
+bool PiIndex::build (const string& path, const uint64_t bound, const int threads, const uint64_t stride)
+{
+	PiIndex old;
+	const bool extend = old.open(path);
+	const uint64_t step = extend ? old.stride : stride;
+	if (step == 0 || step % 2 != 0) {
+		return false;
+	}
+	const uint64_t newBound = (bound + step - 1) / step * step;
+	if (extend && old.bound >= newBound) {
+		return true;  // Already covered
+	}
+
+	// Every new stride is counted on the pool, then the counts are summed into prefixes
+	vector<uint64_t> counts = extend ? old.counts : vector<uint64_t>(1, 0);
+	const uint64_t first = counts.size() - 1, entries = newBound / step + 1;
+	const int workers = Parallel::threadCount(threads);
+	Sieve sieve(long (newBound) - 1, true);
+	vector<Sieve> sieves(workers, sieve);
+	counts.resize(entries);
+	Parallel::forRange(long (entries - 1 - first), workers, [&](long t, int w) {
+		const long lo = long ((first + t) * step);
+		counts[first + t + 1] = uint64_t (sieves[w].count(lo, lo + long (step) - 1));
+	});
+	for (uint64_t j = first; j + 1 < entries; ++j) {
+		counts[j + 1] += counts[j];
+	}
+
+	Header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, indexMagic, sizeof(indexMagic));
+	h.version = PiIndex::version;
+	h.stride = step;
+	h.bound = newBound;
+	h.entries = entries;
+
+	// Written next to the old file and renamed over it, so readers never see a half-written index
+	const string temp = path + ".tmp";
+	FILE* f = fopen(temp.c_str(), "wb");
+	if (f == nullptr) {
+		return false;
+	}
+	bool ok = fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(counts.data(), sizeof(uint64_t), counts.size(), f) == counts.size();
+	ok = fclose(f) == 0 && ok;
+	if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+		remove(temp.c_str());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,45 @@
+#ifndef PIINDEX_H
+#define PIINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class PiIndex  // pi(x) checkpoints at a fixed stride, kept on disk: range counts and nth prime sieve at most half a stride
+{
+	private:
+		struct Header  // File layout: header, then uint64_t counts[entries]
+		{
+			char magic[8];  // "PRMPIIDX"
+			uint32_t version;
+			uint32_t reserved0;
+			uint64_t stride;
+			uint64_t bound;  // Checkpoints cover [0, bound), a multiple of stride
+			uint64_t entries;  // bound / stride + 1
+			uint64_t reserved[3];
+		};
+
+		std::vector<uint64_t> counts;  // counts[j] = number of primes below j * stride
+		uint64_t stride;
+		uint64_t bound;
+
+		static const uint32_t version = 1;
+
+	public:
+		static const uint64_t defaultStride = uint64_t (1) << 24;
+
+		PiIndex ();  // Empty index, covers nothing
+		bool open (const std::string& path);  // Loads an index file; false if missing or invalid
+		void close ();
+		bool covers (const uint64_t n) const { return n < bound; }
+		uint64_t getBound () const { return bound; }
+		uint64_t getStride () const { return stride; }
+
+		long pi (const long n) const;  // Primes <= n, n must be covered: sieves from the nearer checkpoint
+		long count (const long lo, const long hi) const;  // Primes in [lo, hi], hi must be covered
+		long nthPrime (const long k) const;  // The k-th prime (nthPrime(1) = 2), 0 if it is not covered
+
+		static bool build (const std::string& path, const uint64_t bound, const int threads = 1, const uint64_t stride = defaultStride);  // Creates, or extends an existing index, to cover [0, bound)
+};
+
+#endif
@@ -0,0 +1,198 @@
+#include <algorithm>  // func: std::min()
+#include <cstdint>  // Type: uint8_t, uint64_t
+#include <cstdio>  // func: std::fopen(), std::fwrite(), std::rename()
+#include <cstring>  // func: std::memcpy(), std::memcmp()
+#include <string>  // Type: std::string
+#include <vector>  // Type: std::vector
+
+#include <fcntl.h>  // func: open()
+#include <sys/mman.h>  // func: mmap(), munmap()
+#include <sys/stat.h>  // func: fstat()
+#include <unistd.h>  // func: close()
+
+#include "Parallel.h"
+#include "PrimeCache.h"
+#include "Sieve.h"
+
+using namespace std;
+
+static const char cacheMagic[8] = {'P', 'R', 'M', 'C', 'A', 'C', 'H', 'E'};
+
+constexpr Wheel<30> PrimeCache::wheel;
+
+PrimeCache::PrimeCache ()
+{
+	PrimeCache::map = nullptr;
+	PrimeCache::mapSize = 0;
+	PrimeCache::header = nullptr;
+	PrimeCache::counts = nullptr;
+	PrimeCache::bits = nullptr;
+}
+
+PrimeCache::~PrimeCache ()
+{
+	PrimeCache::close();
+}
+
+bool PrimeCache::open (const string& path)
+{
+	PrimeCache::close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || size_t (st.st_size) < sizeof(Header)) {
+		::close(fd);
+		return false;
+	}
+	void* m = mmap(nullptr, size_t (st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);  // The mapping keeps the file alive
+	if (m == MAP_FAILED) {
+		return false;
+	}
+
+	const Header* h = static_cast<const Header*>(m);
+	const uint64_t bytes = h->bound / 30;
+	const bool valid = memcmp(h->magic, cacheMagic, sizeof(cacheMagic)) == 0 && h->version == PrimeCache::version
+		&& h->wheel == 30 && h->bound % 30 == 0 && h->blockBytes == PrimeCache::blockBytes
+		&& h->blocks == (bytes + h->blockBytes - 1) / h->blockBytes
+		&& uint64_t (st.st_size) == sizeof(Header) + h->blocks * sizeof(uint64_t) + bytes;
+	if (!valid) {
+		munmap(m, size_t (st.st_size));
+		return false;
+	}
+
+	PrimeCache::map = m;
+	PrimeCache::mapSize = size_t (st.st_size);
+	PrimeCache::header = h;
+	PrimeCache::counts = reinterpret_cast<const uint64_t*>(h + 1);
+	PrimeCache::bits = reinterpret_cast<const uint8_t*>(PrimeCache::counts + h->blocks);
+	return true;
+}
+
+void PrimeCache::close ()
+{
+	if (PrimeCache::map != nullptr) {
+		munmap(PrimeCache::map, PrimeCache::mapSize);
+	}
+	PrimeCache::map = nullptr;
+	PrimeCache::mapSize = 0;
+	PrimeCache::header = nullptr;
+	PrimeCache::counts = nullptr;
+	PrimeCache::bits = nullptr;
+}
+
+bool PrimeCache::isPrime (const uint64_t n) const
+{
+	if (n < 7) {
+		return n == 2 || n == 3 || n == 5;
+	}
+	const int bit = PrimeCache::wheel.index[n % 30];
+	return bit >= 0 && (PrimeCache::bits[n / 30] >> bit) & 1;
+}
+
+uint64_t PrimeCache::pi (const uint64_t n) const
+{
+	uint64_t total = (n >= 2) + (n >= 3) + (n >= 5);  // The primes the wheel leaves out
+	const uint64_t byte = n / 30;
+	const uint64_t block = byte / PrimeCache::blockBytes;
+	total += PrimeCache::counts[block];
+
+	// Whole bytes from the start of the block, then the bits of the last byte up to n
+	const uint8_t* p = PrimeCache::bits + block * PrimeCache::blockBytes;
+	const uint8_t* end = PrimeCache::bits + byte;
+	for (; p + 8 <= end; p += 8) {
+		uint64_t word;
+		memcpy(&word, p, sizeof(word));
+		total += __builtin_popcountll(word);
+	}
+	for (; p < end; ++p) {
+		total += __builtin_popcount(*p);
+	}
+	int mask = 0;
+	for (int j = 0; j < 8 && PrimeCache::wheel.residues[j] <= int (n % 30); ++j) {
+		mask |= 1 << j;
+	}
+	return total + __builtin_popcount(PrimeCache::bits[byte] & mask);
+}
+
+bool PrimeCache::build (const string& path, const uint64_t bound, const int threads)
+{
+	const uint64_t newBound = (bound + 29) / 30 * 30;
+	PrimeCache old;
+	const uint64_t oldBound = old.open(path) ? old.getBound() : 0;
+	if (oldBound >= newBound) {
+		return true;  // Already covered
+	}
+
+	const uint64_t bytes = newBound / 30, oldBytes = oldBound / 30;
+	Header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, cacheMagic, sizeof(cacheMagic));
+	h.version = PrimeCache::version;
+	h.wheel = 30;
+	h.bound = newBound;
+	h.blockBytes = PrimeCache::blockBytes;
+	h.blocks = (bytes + PrimeCache::blockBytes - 1) / PrimeCache::blockBytes;
+
+	// Written next to the old file and renamed over it, so readers never see a half-written cache
+	const string temp = path + ".tmp";
+	FILE* f = fopen(temp.c_str(), "wb");
+	if (f == nullptr) {
+		return false;
+	}
+	vector<uint64_t> prefix(h.blocks, 0);
+	bool ok = fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(prefix.data(), sizeof(uint64_t), prefix.size(), f) == prefix.size();
+
+	uint64_t running = 0, written = 0;
+	auto emit = [&](const uint8_t* data, size_t length) {
+		for (size_t i = 0; i < length; ++i, ++written) {
+			if (written % PrimeCache::blockBytes == 0) prefix[written / PrimeCache::blockBytes] = running;
+			running += __builtin_popcount(data[i]);
+		}
+		ok = ok && fwrite(data, 1, length, f) == length;
+	};
+
+	// Extending keeps the old bitmap and only sieves the new part
+	if (oldBytes > 0) {
+		emit(old.bits, size_t (oldBytes));
+	}
+	old.close();
+
+	// Chunks of whole wheel bytes that fit one sieve segment, sieved a batch at a time on the pool and written in order
+	const long chunkBytes = Sieve::segmentSpan / 30;
+	const long chunks = long ((bytes - oldBytes + chunkBytes - 1) / chunkBytes);
+	const int workers = Parallel::threadCount(threads);
+	const long batch = 4L * workers;
+	Sieve sieve(long (newBound) - 1, true);
+	vector<Sieve> sieves(workers, sieve);
+	vector<vector<uint8_t> > buffers(batch);
+	for (long first = 0; first < chunks && ok; first += batch) {
+		const long count = min(batch, chunks - first);
+		Parallel::forRange(count, workers, [&](long t, int w) {
+			const uint64_t byte0 = oldBytes + uint64_t (first + t) * chunkBytes;
+			const uint64_t length = min<uint64_t>(chunkBytes, bytes - byte0);
+			const long lo = long (byte0 * 30);
+			vector<uint8_t>& buffer = buffers[t];
+			buffer.assign(length, 0);
+			sieves[w].segment(lo, lo + long (length * 30) - 1);
+			sieves[w].forEach([&](long p) {
+				const int bit = PrimeCache::wheel.index[p % 30];
+				if (bit >= 0) buffer[(p - lo) / 30] |= uint8_t (1 << bit);
+			});
+		});
+		for (long t = 0; t < count; ++t) {
+			emit(buffers[t].data(), buffers[t].size());
+		}
+	}
+
+	ok = ok && fseek(f, long (sizeof(Header)), SEEK_SET) == 0
+		&& fwrite(prefix.data(), sizeof(uint64_t), prefix.size(), f) == prefix.size();
+	ok = fclose(f) == 0 && ok;
+	if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+		remove(temp.c_str());
+		return false;
+	}
+	return true;
+}
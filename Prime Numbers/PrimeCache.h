@@ -0,0 +1,52 @@
+#ifndef PRIMECACHE_H
+#define PRIMECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "StaticPrimes.h"
+
+class PrimeCache  // Read-only, memory-mapped prime bitmap kept on disk between runs
+{
+	private:
+		struct Header  // File layout: header, prefix counts (uint64_t per block), wheel bitmap
+		{
+			char magic[8];  // "PRMCACHE"
+			uint32_t version;
+			uint32_t wheel;  // 30: one byte per 30 numbers, one bit per residue coprime to 30
+			uint64_t bound;  // Every number below bound is covered (a multiple of 30)
+			uint64_t blockBytes;  // Bitmap bytes per prefix count
+			uint64_t blocks;  // Number of prefix counts
+			uint64_t reserved[3];
+		};
+
+		void* map;  // Whole file, mapped read-only
+		size_t mapSize;
+		const Header* header;
+		const uint64_t* counts;  // counts[b] = wheel primes in bitmap bytes [0, b*blockBytes)
+		const uint8_t* bits;
+
+		static const uint32_t version = 1;
+		static constexpr Wheel<30> wheel = Wheel<30>();  // Residues mod 30 of the eight bits of a byte, and residue -> bit (-1 if not coprime to 30)
+
+		PrimeCache (const PrimeCache&) = delete;
+		PrimeCache& operator = (const PrimeCache&) = delete;
+
+	public:
+		static const uint64_t blockBytes = 4096;  // O(segment) work for pi(): at most one block of popcounts
+
+		PrimeCache ();  // Empty cache, covers nothing
+		~PrimeCache ();
+		bool open (const std::string& path);  // Maps an existing cache file; false if missing or invalid
+		void close ();
+		bool covers (const uint64_t n) const { return header != nullptr && n < header->bound; }
+		uint64_t getBound () const { return header ? header->bound : 0; }
+
+		bool isPrime (const uint64_t n) const;  // O(1), n must be covered
+		uint64_t pi (const uint64_t n) const;  // O(blockBytes), n must be covered
+
+		static bool build (const std::string& path, const uint64_t bound, const int threads = 1);  // Creates, or extends an existing cache, to cover [0, bound)
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include <algorithm>  // func: std::min(), std::max(), std::lower_bound()
+#include <vector>  // Type: std::vector
+
+#include "PrimeIterator.h"
+
+using namespace std;
+
+PrimeIterator::PrimeIterator (const long lo, const long hi) : sieve(max(hi, 0L), true)
+{
+	PrimeIterator::position = 0;
+	PrimeIterator::next = max(lo, 0L);
+	PrimeIterator::hi = hi;
+	PrimeIterator::buffer.reserve(Sieve::segmentSpan / 8);
+}
+
+bool PrimeIterator::refill ()
+{
+	PrimeIterator::buffer.clear();
+	PrimeIterator::position = 0;
+	while (PrimeIterator::buffer.empty() && PrimeIterator::next <= PrimeIterator::hi) {
+		const long e = min(PrimeIterator::hi, (PrimeIterator::next & ~1L) + Sieve::segmentSpan - 1);
+		if (PrimeIterator::sieve.segment(PrimeIterator::next, e) > 0) {
+			PrimeIterator::sieve.forEach([this](long p) { PrimeIterator::buffer.push_back(p); });
+		}
+		PrimeIterator::next = e + 1;
+	}
+	return !PrimeIterator::buffer.empty();
+}
+
+bool PrimeIterator::nextPrime (long& p)
+{
+	if (PrimeIterator::position == PrimeIterator::buffer.size() && !PrimeIterator::refill()) {
+		return false;
+	}
+	p = PrimeIterator::buffer[PrimeIterator::position++];
+	return true;
+}
+
+void PrimeIterator::skipTo (const long lo)
+{
+	if (lo >= PrimeIterator::next) {
+		PrimeIterator::buffer.clear();
+		PrimeIterator::position = 0;
+		PrimeIterator::next = lo;
+	} else {
+		PrimeIterator::position = size_t (lower_bound(PrimeIterator::buffer.begin(), PrimeIterator::buffer.end(), lo) - PrimeIterator::buffer.begin());
+	}
+}
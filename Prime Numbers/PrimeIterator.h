@@ -0,0 +1,25 @@
+#ifndef PRIMEITERATOR_H
+#define PRIMEITERATOR_H
+
+#include <vector>
+
+#include "Sieve.h"
+
+class PrimeIterator  // Lazily yields the primes of [lo, hi] in order, one sieve segment at a time
+{
+	private:
+		Sieve sieve;  // O(sqrt(hi)) sieving primes plus one segment
+		std::vector<long> buffer;  // Primes of the current segment
+		size_t position;  // Next prime to hand out from buffer
+		long next;  // Start of the next segment to sieve
+		long hi;
+
+		bool refill ();  // Sieves segments until one has primes; false once past hi
+
+	public:
+		PrimeIterator (const long lo, const long hi);
+		bool nextPrime (long& p);  // Stores the next prime in p; false once the range is exhausted
+		void skipTo (const long lo);  // Continues from the first prime >= lo (lo must not go backwards)
+};
+
+#endif
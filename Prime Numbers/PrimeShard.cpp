@@ -0,0 +1,214 @@
+#include <algorithm>  // func: std::sort(), std::min()
+#include <chrono>  // func: std::chrono::steady_clock::now()
+#include <cstdint>  // Type: uint64_t
+#include <cstdio>  // func: std::fopen(), std::fread(), std::fwrite(), std::rename(), std::snprintf()
+#include <cstdlib>  // func: std::strtoll(), std::strtoull()
+#include <cstring>  // func: std::strcmp(), std::strncmp()
+#include <string>  // Type: std::string
+#include <vector>  // Type: std::vector
+
+#include "Parallel.h"
+#include "PrimeShard.h"
+#include "Sieve.h"
+
+using namespace std;
+
+static const char shardMagic[] = "PRIMESHARD 1";
+
+uint64_t PrimeShard::checksum (const string& text)
+{
+	uint64_t h = 14695981039346656037ULL;
+	for (size_t i = 0; i < text.size(); ++i) {
+		h = (h ^ uint8_t (text[i])) * 1099511628211ULL;
+	}
+	return h;
+}
+
+string PrimeShard::format (const ShardRecord& r)
+{
+	char buffer[512];
+	snprintf(buffer, sizeof(buffer), "%s\nlo %ld\nhi %ld\ndone %ld\ncount %ld\nfirst %ld\nlast %ld\nsum %llu\n",
+		shardMagic, r.lo, r.hi, r.done, r.count, r.first, r.last, (unsigned long long) r.sum);
+	return buffer;
+}
+
+string PrimeShard::text (const ShardRecord& r)
+{
+	const string body = PrimeShard::format(r);
+	char line[64];
+	snprintf(line, sizeof(line), "check %016llx\n", (unsigned long long) PrimeShard::checksum(body));
+	return body + line;
+}
+
+bool PrimeShard::load (const string& path, ShardRecord& r)
+{
+	FILE* f = fopen(path.c_str(), "rb");
+	if (f == nullptr) {
+		return false;
+	}
+	char buffer[1024];
+	const size_t length = fread(buffer, 1, sizeof(buffer) - 1, f);
+	fclose(f);
+	buffer[length] = '\0';
+
+	// Every field, in order, then the checksum of everything before it
+	const char* keys[7] = {"lo", "hi", "done", "count", "first", "last", "sum"};
+	long long values[7];
+	const char* p = buffer;
+	if (strncmp(p, shardMagic, sizeof(shardMagic) - 1) != 0 || p[sizeof(shardMagic) - 1] != '\n') {
+		return false;
+	}
+	p += sizeof(shardMagic);
+	for (int k = 0; k < 7; ++k) {
+		const size_t keyLength = strlen(keys[k]);
+		if (strncmp(p, keys[k], keyLength) != 0 || p[keyLength] != ' ') {
+			return false;
+		}
+		char* end;
+		values[k] = k == 6 ? (long long) strtoull(p + keyLength + 1, &end, 10) : strtoll(p + keyLength + 1, &end, 10);
+		if (end == p + keyLength + 1 || *end != '\n') {
+			return false;
+		}
+		p = end + 1;
+	}
+	ShardRecord loaded;
+	loaded.lo = long (values[0]);
+	loaded.hi = long (values[1]);
+	loaded.done = long (values[2]);
+	loaded.count = long (values[3]);
+	loaded.first = long (values[4]);
+	loaded.last = long (values[5]);
+	loaded.sum = uint64_t (values[6]);
+	if (PrimeShard::text(loaded) != string (buffer)) {
+		return false;  // Checksum (or formatting) mismatch
+	}
+	if (loaded.done < loaded.lo - 1 || loaded.done > loaded.hi) {
+		return false;
+	}
+	r = loaded;
+	return true;
+}
+
+bool PrimeShard::save (const string& path, const ShardRecord& r)
+{
+	const string contents = PrimeShard::text(r);
+	const string temp = path + ".tmp";
+	FILE* f = fopen(temp.c_str(), "wb");
+	if (f == nullptr) {
+		return false;
+	}
+	bool ok = fwrite(contents.data(), 1, contents.size(), f) == contents.size();
+	ok = fclose(f) == 0 && ok;
+	if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+		remove(temp.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool PrimeShard::run (const string& path, const long lo, const long hi, const int threads, ShardRecord& r)
+{
+	if (lo < 0 || hi < lo) {
+		return false;
+	}
+	ShardRecord previous;
+	if (PrimeShard::load(path, previous)) {
+		if (previous.lo != lo || previous.hi != hi) {
+			return false;  // Someone else's shard: never overwrite it
+		}
+		r = previous;
+	} else {
+		r.lo = lo;
+		r.hi = hi;
+		r.done = lo - 1;
+		r.count = 0;
+		r.first = 0;
+		r.last = 0;
+		r.sum = 0;
+	}
+
+	// Batches of segments on the pool; a batch is merged in order, so done always ends a completed segment
+	struct Partial { long count, first, last; uint64_t sum; };
+	const int workers = Parallel::threadCount(threads);
+	const long batch = 4L * workers;
+	Sieve sieve(hi, true);
+	vector<Sieve> sieves(workers, sieve);
+	vector<Partial> partials(batch);
+	vector<long> starts(batch + 1);
+	auto saved = chrono::steady_clock::now();
+	while (r.done < hi) {
+		long segments = 0;
+		for (long s = r.done + 1; segments < batch && s <= hi; ++segments) {
+			starts[segments] = s;
+			s = min(hi, (s & ~1L) + Sieve::segmentSpan - 1) + 1;
+			starts[segments + 1] = s;
+		}
+		Parallel::forRange(segments, workers, [&](long t, int w) {
+			Partial& part = partials[t];
+			part.count = sieves[w].segment(starts[t], starts[t + 1] - 1);
+			part.first = 0;
+			part.last = 0;
+			part.sum = 0;
+			sieves[w].forEach([&](long p) {
+				if (part.first == 0) part.first = p;
+				part.last = p;
+				part.sum += uint64_t (p);
+			});
+		});
+		for (long t = 0; t < segments; ++t) {
+			if (partials[t].count > 0) {
+				if (r.count == 0) r.first = partials[t].first;
+				r.last = partials[t].last;
+				r.count += partials[t].count;
+				r.sum += partials[t].sum;
+			}
+		}
+		r.done = starts[segments] - 1;
+
+		const auto now = chrono::steady_clock::now();
+		if (r.done == hi || now - saved >= chrono::seconds(1)) {
+			if (!PrimeShard::save(path, r)) {
+				return false;
+			}
+			saved = now;
+		}
+	}
+	return true;
+}
+
+bool PrimeShard::merge (vector<ShardRecord> shards, ShardRecord& total, string& error)
+{
+	if (shards.empty()) {
+		error = "no shards";
+		return false;
+	}
+	sort(shards.begin(), shards.end(), [](const ShardRecord& a, const ShardRecord& b) { return a.lo < b.lo; });
+	total = shards[0];
+	total.count = 0;
+	total.first = 0;
+	total.last = 0;
+	total.sum = 0;
+	for (size_t i = 0; i < shards.size(); ++i) {
+		const ShardRecord& s = shards[i];
+		char message[160];
+		if (s.done != s.hi) {
+			snprintf(message, sizeof(message), "shard [%ld, %ld] is incomplete (done up to %ld)", s.lo, s.hi, s.done);
+			error = message;
+			return false;
+		}
+		if (i > 0 && s.lo != total.hi + 1) {
+			snprintf(message, sizeof(message), "shards [.., %ld] and [%ld, ..] %s", total.hi, s.lo, s.lo <= total.hi ? "overlap" : "leave a gap");
+			error = message;
+			return false;
+		}
+		if (s.count > 0) {
+			if (total.count == 0) total.first = s.first;
+			total.last = s.last;
+		}
+		total.count += s.count;
+		total.sum += s.sum;
+		total.hi = s.hi;
+	}
+	total.done = total.hi;
+	return true;
+}
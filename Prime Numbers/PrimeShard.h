@@ -0,0 +1,33 @@
+#ifndef PRIMESHARD_H
+#define PRIMESHARD_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ShardRecord  // Partial result for the primes in [lo, hi]; text file, one "key value" per line
+{
+	long lo;
+	long hi;
+	long done;  // [lo, done] has been counted (lo - 1 before the first segment, hi when complete)
+	long count;
+	long first;  // Smallest and largest prime counted, 0 while count is 0
+	long last;
+	uint64_t sum;  // Sum of the primes counted, mod 2^64: adds up across shards, so a merge can be cross-checked
+};
+
+class PrimeShard  // [Static] Namespace Class: split a prime count over processes or machines, resume, merge
+{
+	private:
+		static uint64_t checksum (const std::string& text);  // FNV-1a, stored as the last line
+		static std::string format (const ShardRecord& r);  // Every line but the checksum
+
+	public:
+		static bool load (const std::string& path, ShardRecord& r);  // False if missing, malformed or the checksum does not match
+		static bool save (const std::string& path, const ShardRecord& r);  // Written next to path and renamed over it
+		static std::string text (const ShardRecord& r);  // File contents, checksum included
+		static bool run (const std::string& path, const long lo, const long hi, const int threads, ShardRecord& r);  // Counts [lo, hi], resuming from path if it holds the same shard; saves at least every second
+		static bool merge (std::vector<ShardRecord> shards, ShardRecord& total, std::string& error);  // Complete shards that tile one range without gaps or overlaps
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include <atomic>  // Type: std::atomic
+#include <chrono>  // func: std::chrono::steady_clock::now()
+#include <cstdint>  // Type: uint64_t
+#include <cstdio>  // func: std::snprintf()
+#include <string>  // Type: std::string
+
+#include "PrimeStats.h"
+
+using namespace std;
+
+#ifdef PRIMES_STATS
+const bool PrimeStats::enabled = true;
+#else
+const bool PrimeStats::enabled = false;
+#endif
+
+atomic<uint64_t> PrimeStats::counters[PrimeStats::stageCount][4];
+
+void PrimeStats::Timeline::enter (const Stage next)
+{
+	PrimeStats::Timeline::close();
+	PrimeStats::Timeline::stage = next;
+	PrimeStats::Timeline::start = chrono::steady_clock::now();
+	PrimeStats::counters[next][0].fetch_add(1, memory_order_relaxed);
+}
+
+void PrimeStats::Timeline::decide ()
+{
+	if (PrimeStats::Timeline::stage >= 0) {
+		PrimeStats::counters[PrimeStats::Timeline::stage][1].fetch_add(1, memory_order_relaxed);
+	}
+}
+
+void PrimeStats::Timeline::work (const uint64_t units)
+{
+	if (PrimeStats::Timeline::stage >= 0) {
+		PrimeStats::counters[PrimeStats::Timeline::stage][3].fetch_add(units, memory_order_relaxed);
+	}
+}
+
+void PrimeStats::Timeline::close ()
+{
+	if (PrimeStats::Timeline::stage >= 0) {
+		const uint64_t elapsed = uint64_t (chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - PrimeStats::Timeline::start).count());
+		PrimeStats::counters[PrimeStats::Timeline::stage][2].fetch_add(elapsed, memory_order_relaxed);
+		PrimeStats::Timeline::stage = -1;
+	}
+}
+
+PrimeStats::Counter PrimeStats::get (const Stage stage)
+{
+	Counter c;
+	c.entered = PrimeStats::counters[stage][0].load(memory_order_relaxed);
+	c.decided = PrimeStats::counters[stage][1].load(memory_order_relaxed);
+	c.nanoseconds = PrimeStats::counters[stage][2].load(memory_order_relaxed);
+	c.work = PrimeStats::counters[stage][3].load(memory_order_relaxed);
+	return c;
+}
+
+const char* PrimeStats::name (const Stage stage)
+{
+	static const char* names[stageCount] = {"cache lookup", "trial division", "Miller-Rabin base 2", "square check", "strong Lucas",
+		"factor table", "factor trial division", "factor split", "Pollard-Brent"};
+	return names[stage];
+}
+
+void PrimeStats::reset ()
+{
+	for (int s = 0; s < stageCount; ++s) {
+		for (int k = 0; k < 4; ++k) {
+			PrimeStats::counters[s][k].store(0, memory_order_relaxed);
+		}
+	}
+}
+
+string PrimeStats::report ()
+{
+	if (!PrimeStats::enabled) {
+		return "stats: not compiled in (build with -DPRIMES_STATS)\n";
+	}
+	string out = "stage                      entered     decided   total ms  ns/entry        work\n";
+	char line[160];
+	for (int s = 0; s < stageCount; ++s) {
+		const Counter c = PrimeStats::get(Stage (s));
+		if (c.entered == 0) continue;
+		snprintf(line, sizeof(line), "%-22s %11llu %11llu %10.3f %9.1f %11llu\n", PrimeStats::name(Stage (s)),
+			(unsigned long long) c.entered, (unsigned long long) c.decided, c.nanoseconds / 1e6,
+			double (c.nanoseconds) / double (c.entered), (unsigned long long) c.work);
+		out += line;
+	}
+	return out;
+}
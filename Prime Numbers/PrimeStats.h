@@ -0,0 +1,65 @@
+#ifndef PRIMESTATS_H
+#define PRIMESTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+class PrimeStats  // [Static] Per-stage counters and timers of the primality and factoring pipelines (compiled in with -DPRIMES_STATS)
+{
+	public:
+		enum Stage {
+			CacheLookup, TrialDivision, MillerRabin, SquareCheck, Lucas,  // isPrimeEfficient / isPrime64
+			FactorTable, FactorTrialDivision, FactorSplit, PollardBrent,  // primeFactorization
+			stageCount
+		};
+		struct Counter
+		{
+			uint64_t entered;  // Inputs that reached the stage
+			uint64_t decided;  // Inputs the stage settled (returned an answer for)
+			uint64_t nanoseconds;  // Time spent in the stage, including the stages it calls
+			uint64_t work;  // Stage specific: Pollard-Brent counts polynomial steps
+		};
+
+		class Timeline  // One call's way through the stages: enter() closes the running stage and opens the next
+		{
+			private:
+				int stage;
+				std::chrono::steady_clock::time_point start;
+
+			public:
+				Timeline () : stage(-1) {}
+				~Timeline () { close(); }
+				void enter (const Stage next);
+				void decide ();  // The running stage settled the input
+				void work (const uint64_t units);
+				void close ();
+		};
+
+		static const bool enabled;  // Built with -DPRIMES_STATS
+		static Counter get (const Stage stage);
+		static const char* name (const Stage stage);
+		static void reset ();
+		static std::string report ();  // One line per stage that was entered
+
+	private:
+		static std::atomic<uint64_t> counters[stageCount][4];  // Same order as Counter, updated with relaxed atomics
+};
+
+// Without PRIMES_STATS the pipelines compile exactly as if these were not there
+#ifdef PRIMES_STATS
+#define PRIMES_STATS_TIMELINE(t) PrimeStats::Timeline t
+#define PRIMES_STATS_ENTER(t, stage) t.enter(PrimeStats::stage)
+#define PRIMES_STATS_DECIDE(t) t.decide()
+#define PRIMES_STATS_WORK(t, units) t.work(units)
+#define PRIMES_STATS_CLOSE(t) t.close()
+#else
+#define PRIMES_STATS_TIMELINE(t) ((void) 0)
+#define PRIMES_STATS_ENTER(t, stage) ((void) 0)
+#define PRIMES_STATS_DECIDE(t) ((void) 0)
+#define PRIMES_STATS_WORK(t, units) ((void) 0)
+#define PRIMES_STATS_CLOSE(t) ((void) 0)
+#endif
+
+#endif
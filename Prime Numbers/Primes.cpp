@@ -1,28 +1,46 @@
+#include <algorithm>  // func: std::min(), std::max(), std::sort()
+#include <cassert>  // func: assert()
 #include <cmath>  // Mathematical Operations
 #include <cstdlib>  // func: std::abs()
 #include <limits>  // numeric_limits<int>::max() etc
-#include <list>  // Type: std::list - std::list<int>
-#include <random>  // func: std::uniform_int_distribution, std::random_device, std::mt19937
+#include <list>  // Type: std::list - std::list<long>
+#include <random>  // func: std::uniform_int_distribution, std::random_device, std::mt19937_64
 #include <string>  // Type: std::string
-#include <utility>  // func: std::swap()
+#include <utility>  // func: std::swap(), std::make_pair() - Type: std::pair
+#include <vector>  // Type: std::vector
 
+#include "Parallel.h"
+#include "PrimeStats.h"
 #include "Primes.h"
+#include "Sieve.h"
 
 using namespace std;
 
-const list<int> Primes::lowPrimes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37,
-	41, 43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113,
-	127, 131, 137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199,
-	211, 223, 227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293,
-	307, 311, 313, 317, 331, 337, 347, 349, 353, 359, 367, 373, 379, 383, 389, 397,
-	401, 409, 419, 421, 431, 433, 439, 443, 449, 457, 461, 463, 467, 479, 487, 491,
-	499, 503, 509, 521, 523, 541, 547, 557, 563, 569, 571, 577, 587, 593, 599, 601,
-	607, 613, 617, 619, 631, 641, 643, 647, 653, 659, 661, 673, 677, 683, 691, 701,
-	709, 719, 727, 733, 739, 743, 751, 757, 761, 769, 773, 787, 797, 809, 811, 821,
-	823, 827, 829, 839, 853, 857, 859, 863, 877, 881, 883, 887, 907, 911, 919, 929,
-	937, 941, 947, 953, 967, 971, 977, 983, 991, 997};
+static_assert(PRIMES_LOW_BOUND > 64, "isPrime64 trial divides by every prime below 64 and needs the next one to stop");
 
-const int Primes::lowPrimesNext = 1009;  
+constexpr PrimeTable<PRIMES_LOW_BOUND> Primes::lowPrimes;
+constexpr uint32_t Primes::lowPrimesNext;
+
+PrimeCache Primes::cache;
+
+bool Primes::useCache (const string& path)
+{
+	return Primes::cache.open(path);
+}
+
+PiIndex Primes::piIndex;
+
+bool Primes::usePiIndex (const string& path)
+{
+	return Primes::piIndex.open(path);
+}
+
+FactorTable Primes::factorTable;
+
+void Primes::useFactorTable (const uint32_t bound, const bool oddOnly)
+{
+	Primes::factorTable = bound > 0 ? FactorTable(bound, oddOnly) : FactorTable();
+}
 
 bool Primes::isPrime (const long n)
 {
@@ -47,85 +65,220 @@ bool Primes::isPrimeEfficient (const long n)
 	// Must use a strictly positive number
 	assert (n > 0);
 
-	// Define 1 to not be a prime
-	if (n == 1) {
-		return false;
+	PRIMES_STATS_TIMELINE(stats);
+	PRIMES_STATS_ENTER(stats, CacheLookup);
+	if (Primes::cache.covers(uint64_t (n))) {
+		PRIMES_STATS_DECIDE(stats);
+		return Primes::cache.isPrime(uint64_t (n));
 	}
-	if (! Primes::fermatTest (n, 10)) {
-		return false;
+	PRIMES_STATS_CLOSE(stats);
+	return Primes::isPrime64(uint64_t (n));
+}
+
+bool Primes::isPrime64 (const uint64_t n)
+{
+	PRIMES_STATS_TIMELINE(stats);
+	PRIMES_STATS_ENTER(stats, TrialDivision);
+	if (n < 4) {
+		PRIMES_STATS_DECIDE(stats);
+		return n == 2 || n == 3;
 	}
-	int cmax = int (sqrt(n));  // Maximum considered factor, int rounds down and computes comparisons faster
-	for (list<int>::const_iterator i = Primes::lowPrimes.begin(); i != Primes::lowPrimes.end(); ++i) {
-		if (*i > cmax) {
-			return true;
-		} else if (n % *i == 0) {
-			return false;
+	// Cheap rejections: most composites have a small factor
+	for (int i = 0; i < Primes::lowPrimes.size && Primes::lowPrimes.primes[i] < 64; ++i) {
+		if (Primes::lowPrimes.divides(i, n)) {
+			PRIMES_STATS_DECIDE(stats);
+			return n == Primes::lowPrimes.primes[i];
 		}
 	}
-	if (! Primes::millerRabinTest (n, 10)) {
+	if (n < 64 * 64) {
+		PRIMES_STATS_DECIDE(stats);
+		return true;
+	}
+
+	// Baillie-PSW: a base 2 strong probable prime that is also a strong Lucas probable prime.
+	// There are no BPSW pseudoprimes below 2^64, so the answer is exact.
+	int s = 0;
+	uint64_t d = n - 1;
+	while (d % 2 == 0) {
+		d /= 2;
+		s++;
+	}
+	PRIMES_STATS_ENTER(stats, MillerRabin);
+	const Montgomery mont(n);
+	if (! Primes::strongProbablePrime(mont, 2, d, s)) {
+		PRIMES_STATS_DECIDE(stats);
 		return false;
 	}
-	// First prime after 997 is 1009
-	if (cmax >= Primes::lowPrimesNext) {
-		for (long i = Primes::lowPrimesNext; i <= cmax; ++i) {
-			if (n % i == 0) {
-				return false;
-			}
-		}
+	PRIMES_STATS_ENTER(stats, SquareCheck);
+	if (Primes::isSquare(n)) {
+		PRIMES_STATS_DECIDE(stats);
+		return false;  // No Selfridge parameter exists for squares
 	}
-	return true;
+	PRIMES_STATS_ENTER(stats, Lucas);
+	PRIMES_STATS_DECIDE(stats);
+	return Primes::strongLucasProbablePrime(mont);
 }
 
-int Primes::pi (const long n)
+long Primes::pi (const long n)
 {
 	if (n < 2) {
 		return 0;
-	} else if (n == 2) {
-		return 1;
-	}
-
-	list<long> primes;
-	primes.push_back(2);
-	bool currentprime = true;
-	for (long p = 3; p <= n; ++p) {
-		currentprime = true;
-		for (list<long>::iterator i = primes.begin(); i != primes.end() && (*i)*(*i) <= p; ++i) {
-			if (p % *i == 0) {
-				currentprime = false;
-				break;
-			}
-		}
-		if (currentprime) {
-			primes.push_back(p);
-		}
 	}
-	return primes.size();
+
+	// Segmented sieve: only the primes up to sqrt(n) and one segment are kept in memory
+	Sieve sieve(n, false);
+	return sieve.count(2, n);
 }
 
-int Primes::piEfficient (const long n)
+long Primes::piEfficient (const long n, const int threads)
 {
 	if (n < 2) {
 		return 0;
 	}
 
-	list<long> primes;
-	for (list<int>::const_iterator i = Primes::lowPrimes.begin(); i != Primes::lowPrimes.end() && *i <= n; ++i) {
-		primes.push_back(*i);
+	if (Primes::cache.covers(uint64_t (n))) {
+		return long (Primes::cache.pi(uint64_t (n)));
 	}
-	bool currentprime = true;
-	for (long p = Primes::lowPrimesNext; p <= n; ++p) {
-		currentprime = true;
-		for (list<long>::iterator i = primes.begin(); i != primes.end() && (*i)*(*i) <= p; ++i) {
-			if (p % *i == 0) {
-				currentprime = false;
-				break;
-			}
+
+	// Same sieve, but every segment starts from a pre-sieved pattern of the smallest primes
+	Sieve sieve(n, true);
+	const int workers = Parallel::threadCount(threads);
+	if (workers == 1) {
+		return sieve.count(2, n);
+	}
+
+	// Segments are handed to the worker pool; every worker sieves into its own buffer and keeps its own count
+	const long segments = (n - 2) / Sieve::segmentSpan + 1;
+	vector<Sieve> sieves(workers, sieve);
+	vector<long> counts(workers, 0);
+	Parallel::forRange(segments, workers, [&](long s, int w) {
+		const long lo = 2 + s * Sieve::segmentSpan;
+		counts[w] += sieves[w].segment(lo, min(n, lo + Sieve::segmentSpan - 1));
+	});
+
+	long total = 0;
+	for (vector<long>::const_iterator i = counts.begin(); i != counts.end(); ++i) {
+		total += *i;
+	}
+	return total;
+}
+
+long Primes::piSublinear (const long n)
+{
+	if (n < 2) {
+		return 0;
+	}
+
+	// S(v) = count of numbers in [2, v] that survive sieving by every prime below p, for each v = n/i.
+	// Sieving by p removes S(v/p) - S(p-1) numbers from S(v). After all p <= sqrt(n), S(n) = pi(n).
+	const long r = Sieve::isqrt(n);
+	vector<long> large(r + 1), small(r + 1);  // large[i] = S(n/i), small[i] = S(i)
+	vector<long> quotient(r + 1);  // quotient[i] = n/i, so the inner loop only divides by p
+	for (long i = 1; i <= r; ++i) {
+		quotient[i] = n / i;
+		large[i] = quotient[i] - 1;
+		small[i] = i - 1;
+	}
+
+	for (long p = 2; p <= r; ++p) {
+		if (small[p] == small[p - 1]) {
+			continue;  // p is not a prime
+		}
+		const long sp = small[p - 1];  // Primes below p
+		const long p2 = p * p;
+		const long end = min(r, n / p2);
+		const long direct = min(end, r / p);  // i*p <= r: read large[] directly
+		for (long i = 1; i <= direct; ++i) {
+			large[i] -= large[i * p] - sp;
 		}
-		if (currentprime) {
-			primes.push_back(p);
+		const double inverse = 1.0 / double (p);  // Floating point quotient, corrected below
+		for (long i = direct + 1; i <= end; ++i) {
+			long q = long (double (quotient[i]) * inverse);  // n/(i*p) = (n/i)/p
+			while (q * p > quotient[i]) --q;
+			while ((q + 1) * p <= quotient[i]) ++q;
+			large[i] -= small[q] - sp;
 		}
+		// small[i] for i in [q*p, q*p + p) all read small[q]
+		for (long q = r / p; q >= p; --q) {
+			const long d = small[q] - sp;
+			for (long i = min(r, q * p + p - 1); i >= q * p; --i) {
+				small[i] -= d;
+			}
+		}
+	}
+	return large[1];
+}
+
+long Primes::primeCount (const long lo, const long hi)
+{
+	if (hi < 2 || hi < lo) {
+		return 0;
+	}
+	if (Primes::cache.covers(uint64_t (hi))) {
+		return long (Primes::cache.pi(uint64_t (hi))) - (lo > 1 ? long (Primes::cache.pi(uint64_t (lo - 1))) : 0);
+	}
+	if (Primes::piIndex.covers(uint64_t (hi))) {
+		return Primes::piIndex.count(lo, hi);
+	}
+	// A short range is cheaper to sieve than to count from 0 twice (2^28 numbers take about as long as piSublinear(10^12))
+	if (hi - lo < (1L << 28)) {
+		return Sieve(hi, true).count(lo, hi);
+	}
+	return Primes::piSublinear(hi) - Primes::piSublinear(lo - 1);
+}
+
+long Primes::nthPrime (const long k)
+{
+	if (k < 1) {
+		return 0;
+	}
+	const long p = Primes::piIndex.nthPrime(k);
+	if (p != 0) {
+		return p;
+	}
+	if (k < 6) {
+		const long first[5] = {2, 3, 5, 7, 11};
+		return first[k - 1];
+	}
+	// Cipolla's estimate x, pi(x), then sieve from x to p_k; p_k < k (ln k + ln ln k) for k >= 6 bounds the sieve
+	const double lk = log(double (k)), llk = log(lk);
+	const long x = long (k * (lk + llk - 1 + (llk - 2) / lk));
+	const long upper = long (k * (lk + llk)) + 1;
+	const long below = Primes::primeCount(0, x);
+	Sieve sieve(max(x, upper), true);
+	return below >= k ? sieve.nth(x, -(below - k + 1)) : sieve.nth(x, k - below);
+}
+
+vector<long> Primes::primeList (const long lo, const long hi, const int threads)
+{
+	vector<long> result;
+	if (hi < 2 || hi < lo) {
+		return result;
+	}
+
+	const long start = max(lo, 2L) & ~1L;  // Even segment base keeps the odd-only bitmaps aligned
+	const long segments = (hi - start) / Sieve::segmentSpan + 1;
+	const int workers = Parallel::threadCount(threads);
+	Sieve sieve(hi, true);
+	vector<Sieve> sieves(workers, sieve);
+	vector<vector<long> > parts(segments);
+	Parallel::forRange(segments, workers, [&](long s, int w) {
+		const long a = start + s * Sieve::segmentSpan;
+		const long b = min(hi, a + Sieve::segmentSpan - 1);
+		parts[s].reserve(sieves[w].segment(max(a, lo), b));
+		sieves[w].forEach([&](long p) { parts[s].push_back(p); });
+	});
+
+	size_t total = 0;
+	for (vector<vector<long> >::const_iterator i = parts.begin(); i != parts.end(); ++i) {
+		total += i->size();
 	}
-	return primes.size();
+	result.reserve(total);
+	for (vector<vector<long> >::iterator i = parts.begin(); i != parts.end(); ++i) {
+		result.insert(result.end(), i->begin(), i->end());
+		vector<long>().swap(*i);
+	}
+	return result;
 }
 
 list<long> Primes::primeFactorize (long n)
@@ -134,30 +287,9 @@ list<long> Primes::primeFactorize (long n)
 	assert (n > 0);
 
 	list<long> factors;
-	int counter;
-
-	for (list<int>::const_iterator i = Primes::lowPrimes.begin(); i != Primes::lowPrimes.end(); ++i) {
-		counter = 0;
-		while (n % *i == 0) {
-			n /= *i;
-			counter += 1;
-		}
-		if (counter > 0) {
-			factors.push_back(*i);
-		}
-		if (n == 1) {
-			break;
-		}
-	}
-	for (int i = Primes::lowPrimesNext; n != 1; ++i) {
-		counter = 0;
-		while (n % i == 0) {
-			n /= i;
-			counter += 1;
-		}
-		if (counter != 0) {
-			factors.push_back(i);
-		}
+	const vector<pair<uint64_t, int> > powers = Primes::primeFactorization(uint64_t (n));
+	for (vector<pair<uint64_t, int> >::const_iterator i = powers.begin(); i != powers.end(); ++i) {
+		factors.push_back(long (i->first));
 	}
 	return factors;
 }
@@ -169,43 +301,171 @@ string Primes::primeDecompose (long n)
 	assert (n > 0);
 
 	string outstr;
-	int counter;
+	const vector<pair<uint64_t, int> > powers = Primes::primeFactorization(uint64_t (n));
+	for (vector<pair<uint64_t, int> >::const_iterator i = powers.begin(); i != powers.end(); ++i) {
+		if (i->second == 1) {
+			outstr += to_string(i->first).append(" ");
+		} else {
+			outstr += to_string(i->first).append("^").append(to_string(i->second)).append(" ");
+		}
+	}
+	if (!outstr.empty()) {
+		return outstr.substr(0, outstr.size()-1);
+	} else {
+		return "ERROR";
+	}
+}
 
-	for (list<int>::const_iterator i = Primes::lowPrimes.begin(); i != Primes::lowPrimes.end(); ++i) {
-		counter = 0;
-		while (n % *i == 0) {
-			n /= *i;
+vector<pair<uint64_t, int> > Primes::primeFactorization (uint64_t n)
+{
+	vector<pair<uint64_t, int> > powers;
+	Primes::primeFactorization(n, powers);
+	return powers;
+}
+
+void Primes::primeFactorization (uint64_t n, vector<pair<uint64_t, int> >& powers)
+{
+	powers.clear();
+	if (n < 2) {
+		return;
+	}
+
+	// O(log n) lookups when the smallest-prime-factor table reaches n
+	PRIMES_STATS_TIMELINE(stats);
+	if (Primes::factorTable.covers(n)) {
+		PRIMES_STATS_ENTER(stats, FactorTable);
+		PRIMES_STATS_DECIDE(stats);
+		uint32_t m = uint32_t (n);
+		while (m != 1) {
+			const uint32_t p = Primes::factorTable.smallestFactor(m);
+			int counter = 0;
+			do {
+				m /= p;
+				counter += 1;
+			} while (m % p == 0);
+			powers.push_back(make_pair(uint64_t (p), counter));
+		}
+		return;
+	}
+
+	// Small factors by trial division (multiplications by inverses), stopping once p^2 > n
+	PRIMES_STATS_ENTER(stats, FactorTrialDivision);
+	if (n % 2 == 0) {
+		const int counter = __builtin_ctzll(n);
+		n >>= counter;
+		powers.push_back(make_pair(uint64_t (2), counter));
+	}
+	for (int i = 1; i < Primes::lowPrimes.size && uint64_t (Primes::lowPrimes.primes[i]) * Primes::lowPrimes.primes[i] <= n; ++i) {
+		int counter = 0;
+		while (Primes::lowPrimes.divides(i, n)) {
+			n *= Primes::lowPrimes.inverses[i];
 			counter += 1;
 		}
-		if (counter == 1) {
-			outstr += to_string(*i).append(" ");
-		} else if (counter > 1) {
-			outstr += to_string(*i).append("^").append(to_string(counter)).append(" ");
+		if (counter > 0) {
+			powers.push_back(make_pair(uint64_t (Primes::lowPrimes.primes[i]), counter));
 		}
-		if (n == 1) {
-			break;
+	}
+	if (n == 1) {
+		PRIMES_STATS_DECIDE(stats);
+		return;
+	}
+
+	// Whatever is left has no factor below min(lowPrimesNext, sqrt(n)): it is a prime if it is below lowPrimesNext^2,
+	// otherwise the primality test and Pollard-Brent split it
+	if (n < uint64_t (Primes::lowPrimesNext) * Primes::lowPrimesNext) {
+		PRIMES_STATS_DECIDE(stats);
+		powers.push_back(make_pair(n, 1));
+		return;
+	}
+	PRIMES_STATS_ENTER(stats, FactorSplit);
+	PRIMES_STATS_DECIDE(stats);
+	const size_t first = powers.size();
+	Primes::splitFactors(n, powers);
+	sort(powers.begin() + first, powers.end());
+
+	// Merge repeated primes into exponents
+	size_t last = first;
+	for (size_t i = first + 1; i < powers.size(); ++i) {
+		if (powers[i].first == powers[last].first) {
+			powers[last].second += 1;
+		} else {
+			powers[++last] = powers[i];
 		}
 	}
-	for (int i = Primes::lowPrimesNext; n != 1; ++i) {
-		counter = 0;
-		while (n % i == 0) {
-			n /= i;
-			counter += 1;
+	powers.resize(last + 1);
+}
+
+void Primes::splitFactors (const uint64_t n, vector<pair<uint64_t, int> >& powers)
+{
+	if (n == 1) {
+		return;
+	}
+	if (Primes::isPrime64(n)) {
+		powers.push_back(make_pair(n, 1));
+		return;
+	}
+	const uint64_t d = Primes::pollardBrent(n);
+	Primes::splitFactors(d, powers);
+	Primes::splitFactors(n / d, powers);
+}
+
+uint64_t Primes::pollardBrent (const uint64_t n)
+{
+	// Brent's cycle detection on f(x) = x^2 + c, all in Montgomery form (gcds are unaffected since R is coprime to n).
+	// The differences are multiplied together and only every `batch` steps is a gcd taken.
+	PRIMES_STATS_TIMELINE(stats);
+	PRIMES_STATS_ENTER(stats, PollardBrent);
+	const Montgomery mont(n);
+	const int batch = 128;
+	for (uint64_t c = 1; ; ++c) {
+		const uint64_t cForm = mont.toForm(c);
+		uint64_t x = 0, y = mont.toForm(2), ys = y, q = mont.one(), g = 1;
+		for (long r = 1; g == 1; r *= 2) {
+			x = y;
+			for (long i = 0; i < r; ++i) {
+				y = mont.add(mont.multiply(y, y), cForm);
+			}
+			PRIMES_STATS_WORK(stats, uint64_t (r));
+			for (long k = 0; k < r && g == 1; k += batch) {
+				ys = y;
+				for (long i = 0; i < batch && i < r - k; ++i) {
+					y = mont.add(mont.multiply(y, y), cForm);
+					q = mont.multiply(q, x > y ? x - y : y - x);
+				}
+				PRIMES_STATS_WORK(stats, uint64_t (min(long (batch), r - k)));
+				g = Primes::gcd64(q, n);
+			}
+		}
+		if (g == n) {
+			// The batch overshot (or q hit 0): redo it one step at a time from its start
+			do {
+				ys = mont.add(mont.multiply(ys, ys), cForm);
+				g = Primes::gcd64(x > ys ? x - ys : ys - x, n);
+			} while (g == 1);
 		}
-		if (counter == 1) {
-			outstr += to_string(i).append(" ");
-		} else if (counter > 1) {
-			outstr += to_string(i).append("^").append(to_string(counter)).append(" ");
+		if (g != n) {
+			PRIMES_STATS_DECIDE(stats);
+			return g;
 		}
+		// The cycle closed without splitting n: try another polynomial
 	}
-	if (!outstr.empty()) {
-		//outstr.erase (1, 1);
-		return outstr.substr(0, outstr.size()-1);
-		//return outstr;
-	} else {
-		return "ERROR";
+}
+
+uint64_t Primes::gcd64 (uint64_t a, uint64_t b)
+{
+	if (a == 0 || b == 0) {
+		return a | b;
+	}
+	const int shift = __builtin_ctzll(a | b);
+	a >>= __builtin_ctzll(a);
+	while (b != 0) {
+		b >>= __builtin_ctzll(b);
+		if (a > b) {
+			swap(a, b);
+		}
+		b -= a;
 	}
-	return outstr;
+	return a << shift;
 }
 
 // Primality Tests and Related Important Private Methods
@@ -268,6 +528,26 @@ bool Primes::solovayStrassenTest (long n)
 }
 */
 
+int Primes::jakobiSymbolU (uint64_t a, uint64_t n)  // Same as above on unsigned values
+{
+	int j = 1;
+	while (a != 0) {
+		while (a % 2 == 0) {
+			a = a/2;
+			int nmod = n % 8;
+			if (nmod == 3 || nmod == 5) {
+				j = -j;
+			}
+		}
+		swap(a, n);
+		if (a % 4 == 3 && n % 4 == 3) {
+			j = -j;
+		}
+		a = a % n;
+	}
+	return n==1 ? j : 0;
+}
+
 int Primes::powermod (int a, int n, const int p)
 {
 	int m = 1;  // Result
@@ -291,14 +571,15 @@ long Primes::powermodL (long a, long n, const long p)
 	long m = 1;  // Result
 	a %= p;
 
+	// Products are taken in 128 bits: (m*a) overflows long as soon as p > 2^31.5
 	while (n > 0) {
 		if (n % 2 == 1) {
-			m = (m*a) % p;
+			m = long ((__int128) m * a % p);
 		}
 
 		// n must be even now
 		n = n >> 1;
-		a = (a * a) % p;
+		a = long ((__int128) a * a % p);
 	}
 
 	return m;
@@ -333,8 +614,8 @@ bool Primes::fermatTest (const long n, const int k)  // Tries k times
 	// Trivial Cases
 	if (n < 4) return n == 2 || n == 3;  // It is still asserted that n>0 for error catching.
 
-	//uniformly random generator
-	default_random_engine generator;
+	//uniformly random generator, seeded once per thread
+	static thread_local mt19937_64 generator(random_device{}());
 	uniform_int_distribution<long>  distr(2, n-2);
 
 	for (int i = 0; i < k; ++i) {
@@ -357,44 +638,113 @@ bool Primes::millerRabinTest (const long n, const int k)  // Tries k times
 
 	// Trivial Cases
 	if (n < 4) return n == 2 || n == 3;  // It is still asserted that n>0 for error catching.
+	if (n % 2 == 0) return false;
 
+	int s = 0;
 	long d = n - 1;
 	while (d % 2 == 0) {
 		d /= 2;
+		s++;
 	}
 
-	//uniformly random generator
-	default_random_engine generator;
+	//uniformly random generator, seeded once per thread
+	static thread_local mt19937_64 generator(random_device{}());
 	uniform_int_distribution<long>  distr(2, n-2);
 
+	const Montgomery mont(n);
 	for (int i = 0; i < k; ++i) {
-		long a = distr(generator);
-		long x = powermodL(a, d, n);
-		bool notFlip;
-
-		// Miller Rabin Test
-		if (x != 1 && x != n - 1) {
-			// Keep squaring x while one of the following doesn't 
-			// happen 
-			// (i)   d does not reach n-1 
-			// (ii)  (x^2) % n is not 1 
-			// (iii) (x^2) % n is not n-1 
-			notFlip = true;  // condition (iii) has not been satisfied
-			while (d != n - 1) {
-				x = (x * x) % n;
-				d *= 2;
-
-				if (x == 1) {
-					return false;
-				} else if (n == n - 1) {
-					notFlip = false;
-					break;
-				}
-			}
-			if (notFlip) return false;
+		if (! Primes::strongProbablePrime(mont, uint64_t (distr(generator)), uint64_t (d), s)) {
+			return false;
 		}
 	}
 
 	// Miller Rabin tests passed
 	return true;
 }
+
+bool Primes::strongProbablePrime (const Montgomery& mont, const uint64_t a, const uint64_t d, const int s)
+{
+	// Passes if a^d = 1 or a^(d*2^r) = -1 (mod n) for some 0 <= r < s
+	const uint64_t one = mont.one();
+	const uint64_t minusOne = mont.modulus() - one;
+	uint64_t x = a == 2 ? mont.powerOfTwo(d) : mont.power(mont.toForm(a), d);
+	if (x == one || x == minusOne) {
+		return true;
+	}
+	for (int r = 1; r < s; ++r) {
+		x = mont.multiply(x, x);
+		if (x == minusOne) {
+			return true;
+		} else if (x == one) {
+			return false;
+		}
+	}
+	return false;
+}
+
+bool Primes::strongLucasProbablePrime (const Montgomery& mont)
+{
+	const uint64_t n = mont.modulus();
+
+	// Selfridge's method A: the first D in 5, -7, 9, -11, ... with (D/n) = -1, then P = 1, Q = (1-D)/4.
+	// (D/n) = (-1/n)^[D<0] (|D|/n), and reciprocity turns (|D|/n) into a symbol on small values
+	long D = 5;
+	for (;;) {
+		const uint64_t a = uint64_t (labs(D));
+		int j = Primes::jakobiSymbolU(n % a, a);
+		if (((a - 1) / 2) % 2 == 1 && n % 4 == 3) j = -j;
+		if (D < 0 && n % 4 == 3) j = -j;
+		if (j == -1) {
+			break;
+		} else if (j == 0 && a % n != 0) {
+			return false;  // D shares a factor with n
+		}
+		D = D > 0 ? -(D + 2) : -D + 2;
+	}
+
+	const long Q = (1 - D) / 4;
+	const uint64_t one = mont.one(), two = mont.add(one, one);
+	const uint64_t qForm = Q > 0 ? mont.toForm(uint64_t (Q)) : mont.subtract(0, mont.toForm(uint64_t (-Q)));
+
+	// n+1 = d*2^s (n is odd and not 2^64-1, which has the factor 3)
+	const int s = __builtin_ctzll(n + 1);
+	const uint64_t d = (n + 1) >> s;
+
+	// Ladder over d on V_k, V_k+1 and Q^k, Q^k+1 from k = 0, leaving U out: four products per bit instead of up to
+	// seven, independent of each other, and picked by mask as in powerOfTwo(). With P = 1,
+	//   V_2k = V_k^2 - 2Q^k,  V_2k+1 = V_k V_k+1 - Q^k,  V_2k+2 = V_k+1^2 - 2Q^k+1
+	uint64_t V0 = two, V1 = one, Q0 = one, Q1 = qForm;
+	for (int bit = 63 - __builtin_clzll(d); bit >= 0; --bit) {
+		const uint64_t mask = 0 - ((d >> bit) & 1);
+		const uint64_t Vs = (V1 & mask) | (V0 & ~mask), Qs = (Q1 & mask) | (Q0 & ~mask);
+		const uint64_t cross = mont.subtract(mont.multiply(V0, V1), Q0);
+		const uint64_t square = mont.subtract(mont.multiply(Vs, Vs), mont.add(Qs, Qs));
+		const uint64_t qCross = mont.multiply(Q0, Q1), qSquare = mont.multiply(Qs, Qs);
+		V0 = (cross & mask) | (square & ~mask);
+		V1 = (square & mask) | (cross & ~mask);
+		Q0 = (qCross & mask) | (qSquare & ~mask);
+		Q1 = (qSquare & mask) | (qCross & ~mask);
+	}
+
+	// Strong test: U_d = 0, read off D U_d = 2 V_d+1 - P V_d (D is invertible, (D/n) being -1), or V_(d*2^r) = 0 for
+	// some 0 <= r < s
+	if (mont.add(V1, V1) == V0 || V0 == 0) {
+		return true;
+	}
+	for (int r = 1; r < s; ++r) {
+		V0 = mont.subtract(mont.multiply(V0, V0), mont.add(Q0, Q0));
+		Q0 = mont.multiply(Q0, Q0);
+		if (V0 == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Primes::isSquare (const uint64_t n)
+{
+	uint64_t r = uint64_t (sqrt(double (n)));
+	while (r * r > n) --r;
+	while ((r + 1) * (r + 1) <= n && r < 0xFFFFFFFFULL) ++r;
+	return r * r == n;
+}
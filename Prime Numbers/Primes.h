@@ -1,14 +1,28 @@
 #ifndef PRIMES_H
 #define PRIMES_H
 
+#include <cstdint>
 #include <list>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "FactorTable.h"
+#include "Montgomery.h"
+#include "Montgomery128.h"
+#include "PiIndex.h"
+#include "PrimeCache.h"
+#include "Sieve.h"
+#include "StaticPrimes.h"
 
 class Primes  // [Static] Namespace Class (No Instantiation)
 {
 	private:
-		static const std::list<int> lowPrimes;  // Some small primes below 10^3
-		static const int lowPrimesNext; // Smallest prime after the array
+		static constexpr PrimeTable<PRIMES_LOW_BOUND> lowPrimes = PrimeTable<PRIMES_LOW_BOUND>();  // Every prime below PRIMES_LOW_BOUND, generated at compile time
+		static constexpr uint32_t lowPrimesNext = PrimeTable<PRIMES_LOW_BOUND>::next;  // Smallest prime after the table
+		static PrimeCache cache;  // Optional on-disk bitmap, consulted below its bound
+		static FactorTable factorTable;  // Optional smallest-prime-factor table, used when it covers the input
+		static PiIndex piIndex;  // Optional on-disk pi(x) checkpoints for primeCount and nthPrime
 		// Primality Tests
 		static int powermod (int a, int n, const int p);  // calculates (a^n) % p in O(log y)
 		static long powermodL (long a, long n, const long p);  // For large numbers
@@ -16,16 +30,57 @@ class Primes  // [Static] Namespace Class (No Instantiation)
 		static long gcdL(const long a, const long b);  // For large numbers
 		static int jakobiSymbol (int a, int n);
 		static int jakobiSymbolL (long a, long n);  // For large numbers
+		static int jakobiSymbolU (uint64_t a, uint64_t n);  // For unsigned 64-bit numbers (n odd)
 		static bool fermatTest (const long n, const int k = 5);  // k tries
 		static bool millerRabinTest (const long n, const int k = 5);
+		static bool strongProbablePrime (const Montgomery& mont, const uint64_t a, const uint64_t d, const int s);  // One Miller-Rabin round, n-1 = d*2^s
+		static bool strongLucasProbablePrime (const Montgomery& mont);  // Strong Lucas test with Selfridge's parameters
+		static bool isSquare (const uint64_t n);
+		// Factorization
+		static uint64_t gcd64 (uint64_t a, uint64_t b);  // Binary (Stein's) gcd
+		static uint64_t pollardBrent (const uint64_t n);  // A nontrivial factor of an odd composite n
+		static void splitFactors (const uint64_t n, std::vector<std::pair<uint64_t, int> >& powers);  // Appends (p, 1) for every prime factor of n
+		// 128-bit (Primes128.cpp)
+		static const std::vector<std::pair<uint64_t, int> >& lowPrimeGroups ();  // Products of consecutive odd low primes that fit 64 bits, with the index after each group
+		static bool strongProbablePrime128 (const Montgomery128& mont, const unsigned __int128 d, const int s);  // Base 2, n-1 = d*2^s
+		static bool strongLucasProbablePrime128 (const Montgomery128& mont);
+		static bool isSquare128 (const unsigned __int128 n);
+		static unsigned __int128 gcd128 (unsigned __int128 a, unsigned __int128 b);
+		static unsigned __int128 pollardBrent128 (const unsigned __int128 n);
+		static void splitFactors128 (const unsigned __int128 n, std::vector<std::pair<unsigned __int128, int> >& powers);
+		// Multiplicative functions (PrimesMultiplicative.cpp)
+		static void multiplicativeSegment (const long lo, const long hi, const long first, const std::vector<uint32_t>& primes, const std::vector<uint64_t>& inverses,
+			std::vector<uint64_t>& rem, uint64_t* phi, int8_t* mu, uint64_t* sigma, uint8_t* omega);  // One segment of multiplicativeRange, outputs indexed from first
 		//static bool solovayStrassenTest (long n);  // Can't be used
 	public:
 		static bool isPrime (const long n);
 		static bool isPrimeEfficient (const long n);
-		static int pi (const long n);
-		static int piEfficient (const long n);
+		static bool isPrime64 (const uint64_t n);  // Baillie-PSW, exact for every 64-bit input
+		static void isPrimeBatch (const uint64_t* values, const size_t count, uint8_t* out);  // out[i] = isPrime64(values[i]), SIMD lanes where available
+		static const char* batchKernelName ();  // Kernel isPrimeBatch picked for this CPU: "avx512", "avx2" or "scalar"
+		static long pi (const long n);
+		static long piEfficient (const long n, const int threads = 1);  // threads <= 0 uses every core
+		static long piSublinear (const long n);  // Lucy_Hedgehog's method, O(n^(3/4)) time and O(sqrt(n)) memory
+		static std::vector<long> primeList (const long lo, const long hi, const int threads = 1);  // All primes in [lo, hi], in order
+		template <class F> static void forEachPrime (const long lo, const long hi, F callback);  // Streams the primes of [lo, hi] in O(sqrt(hi)) memory
+		static bool useCache (const std::string& path);  // Maps a cache built with PrimeCache::build (false if missing/invalid)
+		static bool usePiIndex (const std::string& path);  // Loads an index built with PiIndex::build (false if missing/invalid)
+		static long primeCount (const long lo, const long hi);  // Primes in [lo, hi]: cache, index checkpoints, a sieve for short ranges, else piSublinear
+		static long nthPrime (const long k);  // The k-th prime (nthPrime(1) = 2)
+		static void useFactorTable (const uint32_t bound, const bool oddOnly = false);  // Factor every n <= bound by table lookups (0 drops the table)
 		static std::list<long> primeFactorize(long n);  // Passes back a list object
+		static std::vector<std::pair<uint64_t, int> > primeFactorization (uint64_t n);  // (prime, exponent) pairs, increasing
+		static void primeFactorization (uint64_t n, std::vector<std::pair<uint64_t, int> >& powers);  // Same, reusing the caller's vector
 		static std::string primeDecompose(long n);  // Check java file for original function
+		// Whole ranges at once, out[i] belongs to lo + i (lo >= 1): segmented O(n log log n) sieves, parallel over segments
+		static void multiplicativeRange (const long lo, const long hi, uint64_t* phi, int8_t* mu, uint64_t* sigma, uint8_t* omega, const int threads = 1);  // Any of the outputs may be null
+		static void totientRange (const long lo, const long hi, uint64_t* out, const int threads = 1);  // Euler's phi
+		static void mobiusRange (const long lo, const long hi, int8_t* out, const int threads = 1);  // Moebius mu
+		static void divisorSumRange (const long lo, const long hi, uint64_t* out, const int threads = 1);  // sigma, the sum of divisors
+		static void distinctFactorsRange (const long lo, const long hi, uint8_t* out, const int threads = 1);  // omega, the number of distinct prime factors
+		static bool isPrime128 (const unsigned __int128 n);  // Baillie-PSW in 128-bit Montgomery form (no pseudoprime is known above 2^64)
+		static std::vector<std::pair<unsigned __int128, int> > primeFactorization128 (unsigned __int128 n);  // Pollard-Brent: practical while the second largest factor is below ~2^50
+		static void primeFactorization128 (unsigned __int128 n, std::vector<std::pair<unsigned __int128, int> >& powers);  // Same, reusing the caller's vector
 
 		//temporary access
 		static int jakobi (int a, int n) {return jakobiSymbol(a, n);}
@@ -33,4 +88,17 @@ class Primes  // [Static] Namespace Class (No Instantiation)
 		static bool miller (long n, int k) {return millerRabinTest(n, k);}
 };
 
+template <class F>
+void Primes::forEachPrime (const long lo, const long hi, F callback)
+{
+	Sieve sieve(hi > 0 ? hi : 0, true);
+	for (long s = lo > 0 ? lo : 0; s <= hi; ) {
+		const long e = (s & ~1L) + Sieve::segmentSpan - 1 < hi ? (s & ~1L) + Sieve::segmentSpan - 1 : hi;
+		if (sieve.segment(s, e) > 0) {
+			sieve.forEach(callback);
+		}
+		s = e + 1;
+	}
+}
+
 #endif
@@ -0,0 +1,287 @@
+#include <algorithm>  // func: std::sort(), std::swap()
+#include <cmath>  // func: std::sqrt()
+#include <cstdint>  // Type: uint64_t
+#include <utility>  // func: std::make_pair() - Type: std::pair
+#include <vector>  // Type: std::vector
+
+#include "Montgomery128.h"
+#include "Primes.h"
+
+using namespace std;
+
+typedef unsigned __int128 u128;
+
+static inline int trailingZeros128 (const u128 n)  // n != 0
+{
+	return uint64_t (n) ? __builtin_ctzll(uint64_t (n)) : 64 + __builtin_ctzll(uint64_t (n >> 64));
+}
+
+static inline int leadingZeros128 (const u128 n)  // n != 0
+{
+	return n >> 64 ? __builtin_clzll(uint64_t (n >> 64)) : 64 + __builtin_clzll(uint64_t (n));
+}
+
+const vector<pair<uint64_t, int> >& Primes::lowPrimeGroups ()
+{
+	// n % product costs one 128/64 division for a whole group; each prime then needs a 64-bit test on the residue
+	static const vector<pair<uint64_t, int> > groups = [] {
+		vector<pair<uint64_t, int> > g;
+		uint64_t product = 1;
+		for (int i = 1; i < Primes::lowPrimes.size; ++i) {
+			const uint64_t p = Primes::lowPrimes.primes[i];
+			if (product > UINT64_MAX / p) {
+				g.push_back(make_pair(product, i));
+				product = 1;
+			}
+			product *= p;
+		}
+		g.push_back(make_pair(product, int (Primes::lowPrimes.size)));
+		return g;
+	}();
+	return groups;
+}
+
+bool Primes::isPrime128 (const u128 n)
+{
+	if (n >> 64 == 0) {
+		return Primes::isPrime64(uint64_t (n));
+	}
+	if (n % 2 == 0) {
+		return false;
+	}
+	// Cheap rejections: the odd primes below 256, a group at a time (n > 2^64 is never one of them)
+	const vector<pair<uint64_t, int> >& groups = Primes::lowPrimeGroups();
+	for (size_t k = 0, i = 1; k < groups.size() && Primes::lowPrimes.primes[i] < 256; ++k) {
+		const uint64_t r = uint64_t (n % groups[k].first);
+		for (; int (i) < groups[k].second; ++i) {
+			if (Primes::lowPrimes.divides(int (i), r)) {
+				return false;
+			}
+		}
+	}
+
+	// Baillie-PSW, as in isPrime64
+	const int s = trailingZeros128(n - 1);
+	const Montgomery128 mont(n);
+	if (! Primes::strongProbablePrime128(mont, (n - 1) >> s, s)) {
+		return false;
+	}
+	if (Primes::isSquare128(n)) {
+		return false;
+	}
+	return Primes::strongLucasProbablePrime128(mont);
+}
+
+bool Primes::strongProbablePrime128 (const Montgomery128& mont, const u128 d, const int s)
+{
+	const u128 one = mont.one();
+	const u128 minusOne = mont.modulus() - one;
+	u128 x = mont.power(mont.add(one, one), d);
+	if (x == one || x == minusOne) {
+		return true;
+	}
+	for (int r = 1; r < s; ++r) {
+		x = mont.multiply(x, x);
+		if (x == minusOne) {
+			return true;
+		} else if (x == one) {
+			return false;
+		}
+	}
+	return false;
+}
+
+bool Primes::strongLucasProbablePrime128 (const Montgomery128& mont)
+{
+	const u128 n = mont.modulus();
+
+	// Selfridge's method A. (D/n) = (-1/n)^[D<0] (|D|/n), and reciprocity turns (|D|/n) into a 64-bit symbol
+	long D = 5;
+	for (;;) {
+		const uint64_t a = uint64_t (labs(D));
+		int j = Primes::jakobiSymbolU(uint64_t (n % a), a);
+		if (((a - 1) / 2) % 2 == 1 && n % 4 == 3) j = -j;
+		if (D < 0 && n % 4 == 3) j = -j;
+		if (j == -1) {
+			break;
+		} else if (j == 0) {
+			return false;  // D shares a factor with n (n > 2^64 > |D|)
+		}
+		D = D > 0 ? -(D + 2) : -D + 2;
+	}
+	const long Q = (1 - D) / 4;
+	const u128 dForm = D > 0 ? mont.small(uint64_t (D)) : mont.subtract(0, mont.small(uint64_t (-D)));
+	const u128 qForm = Q > 0 ? mont.small(uint64_t (Q)) : mont.subtract(0, mont.small(uint64_t (-Q)));
+
+	// n+1 = d*2^s (n+1 does not overflow: 2^128-1 has the factor 3)
+	const int s = trailingZeros128(n + 1);
+	const u128 d = (n + 1) >> s;
+
+	// Left-to-right binary chain over d: U_k, V_k, Q^k, starting from k = 1
+	u128 U = mont.one(), V = mont.one(), Qk = qForm;
+	for (int bit = 126 - leadingZeros128(d); bit >= 0; --bit) {
+		U = mont.multiply(U, V);  // U_2k = U_k V_k
+		V = mont.subtract(mont.multiply(V, V), mont.add(Qk, Qk));  // V_2k = V_k^2 - 2Q^k
+		Qk = mont.multiply(Qk, Qk);
+		if ((d >> bit) & 1) {
+			const u128 U1 = mont.half(mont.add(U, V));  // U_k+1 = (P U_k + V_k)/2
+			V = mont.half(mont.add(mont.multiply(dForm, U), V));  // V_k+1 = (D U_k + P V_k)/2
+			U = U1;
+			Qk = mont.multiply(Qk, qForm);
+		}
+	}
+
+	// Strong test: U_d = 0, or V_(d*2^r) = 0 for some 0 <= r < s
+	if (U == 0 || V == 0) {
+		return true;
+	}
+	for (int r = 1; r < s; ++r) {
+		V = mont.subtract(mont.multiply(V, V), mont.add(Qk, Qk));
+		Qk = mont.multiply(Qk, Qk);
+		if (V == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Primes::isSquare128 (const u128 n)
+{
+	const long double root = sqrtl((long double) n);
+	uint64_t r = root >= 18446744073709551615.0L ? UINT64_MAX : uint64_t (root);
+	while ((u128) r * r > n) --r;
+	while (r < UINT64_MAX && (u128) (r + 1) * (r + 1) <= n) ++r;
+	return (u128) r * r == n;
+}
+
+u128 Primes::gcd128 (u128 a, u128 b)
+{
+	if (a == 0 || b == 0) {
+		return a | b;
+	}
+	const int shift = trailingZeros128(a | b);
+	a >>= trailingZeros128(a);
+	while (b != 0) {
+		b >>= trailingZeros128(b);
+		if (a > b) {
+			swap(a, b);
+		}
+		b -= a;
+	}
+	return a << shift;
+}
+
+u128 Primes::pollardBrent128 (const u128 n)
+{
+	// Same as pollardBrent, in 128-bit Montgomery form
+	const Montgomery128 mont(n);
+	const int batch = 128;
+	for (uint64_t c = 1; ; ++c) {
+		const u128 cForm = mont.small(c);
+		u128 x = 0, y = mont.small(2), ys = y, q = mont.one(), g = 1;
+		for (long r = 1; g == 1; r *= 2) {
+			x = y;
+			for (long i = 0; i < r; ++i) {
+				y = mont.add(mont.multiply(y, y), cForm);
+			}
+			for (long k = 0; k < r && g == 1; k += batch) {
+				ys = y;
+				for (long i = 0; i < batch && i < r - k; ++i) {
+					y = mont.add(mont.multiply(y, y), cForm);
+					q = mont.multiply(q, x > y ? x - y : y - x);
+				}
+				g = Primes::gcd128(q, n);
+			}
+		}
+		if (g == n) {
+			do {
+				ys = mont.add(mont.multiply(ys, ys), cForm);
+				g = Primes::gcd128(x > ys ? x - ys : ys - x, n);
+			} while (g == 1);
+		}
+		if (g != n) {
+			return g;
+		}
+	}
+}
+
+void Primes::splitFactors128 (const u128 n, vector<pair<u128, int> >& powers)
+{
+	if (n >> 64 == 0) {
+		vector<pair<uint64_t, int> > factors;
+		Primes::splitFactors(uint64_t (n), factors);
+		for (size_t i = 0; i < factors.size(); ++i) {
+			powers.push_back(make_pair(u128 (factors[i].first), factors[i].second));
+		}
+		return;
+	}
+	if (Primes::isPrime128(n)) {
+		powers.push_back(make_pair(n, 1));
+		return;
+	}
+	const u128 d = Primes::pollardBrent128(n);
+	Primes::splitFactors128(d, powers);
+	Primes::splitFactors128(n / d, powers);
+}
+
+vector<pair<u128, int> > Primes::primeFactorization128 (u128 n)
+{
+	vector<pair<u128, int> > powers;
+	Primes::primeFactorization128(n, powers);
+	return powers;
+}
+
+void Primes::primeFactorization128 (u128 n, vector<pair<u128, int> >& powers)
+{
+	static thread_local vector<pair<uint64_t, int> > tail;  // The part below 2^64, factored by the 64-bit code
+	powers.clear();
+	if (n < 2) {
+		return;
+	}
+
+	// Small factors: one 128/64 division per group of low primes, then exact divisions for the primes found
+	if (n % 2 == 0) {
+		const int counter = trailingZeros128(n);
+		n >>= counter;
+		powers.push_back(make_pair(u128 (2), counter));
+	}
+	const vector<pair<uint64_t, int> >& groups = Primes::lowPrimeGroups();
+	for (size_t k = 0, i = 1; k < groups.size() && n >> 64 != 0; ++k) {
+		const uint64_t r = uint64_t (n % groups[k].first);
+		for (; int (i) < groups[k].second; ++i) {
+			if (Primes::lowPrimes.divides(int (i), r)) {
+				const uint32_t p = Primes::lowPrimes.primes[i];
+				int counter = 0;
+				do {
+					n /= p;
+					counter += 1;
+				} while (n % p == 0);
+				powers.push_back(make_pair(u128 (p), counter));
+			}
+		}
+	}
+
+	// Below 2^64 the rest is the 64-bit factorization (which repeats only the cheap trial division)
+	if (n >> 64 == 0) {
+		Primes::primeFactorization(uint64_t (n), tail);
+		for (size_t i = 0; i < tail.size(); ++i) {
+			powers.push_back(make_pair(u128 (tail[i].first), tail[i].second));
+		}
+		sort(powers.begin(), powers.end());
+		return;
+	}
+	const size_t first = powers.size();
+	Primes::splitFactors128(n, powers);
+	sort(powers.begin() + first, powers.end());
+
+	// Merge repeated primes into exponents
+	size_t last = first;
+	for (size_t i = first + 1; i < powers.size(); ++i) {
+		if (powers[i].first == powers[last].first) {
+			powers[last].second += powers[i].second;
+		} else {
+			powers[++last] = powers[i];
+		}
+	}
+	powers.resize(last + 1);
+}
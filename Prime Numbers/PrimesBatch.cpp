@@ -0,0 +1,570 @@
+#include <algorithm>  // func: std::min()
+#include <cstddef>  // Type: size_t
+#include <cstdint>  // Type: uint8_t, uint32_t, uint64_t
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>  // AVX2 / AVX-512 intrinsics
+#define PRIMES_X86 1
+#endif
+
+#include "Primes.h"
+
+using namespace std;
+
+// Batch primality: a scalar pre-filter settles small values and values with a factor below 64, the 32-bit survivors
+// go through Miller-Rabin with bases {2, 7, 61} (exact below 4,759,123,141) several lanes at a time, and the wider
+// ones get the base 2 strong test in lanes and then, if they pass, the scalar strong Lucas test: the same Baillie-PSW
+// as isPrime64. Base 2 runs first on every 32-bit survivor; only the ones that pass it get bases 7 and 61.
+// The 32-bit kernels use Montgomery arithmetic with R = 2^32 in 64-bit lanes, since 32x32->64 multiplies are what
+// AVX2 and AVX-512F provide; the wide ones use R = 2^64, each 64x64->128 product put together from four of those.
+// All keep two vectors in flight to hide the multiply latency.
+
+typedef void (*BatchKernel) (const uint32_t* values, size_t count, const uint32_t* bases, int nbases, uint8_t* result);
+typedef void (*WideKernel) (const uint64_t* values, size_t count, uint8_t* result);  // Base 2 strong test
+
+static const uint32_t firstBase[1] = {2};
+static const uint32_t otherBases[2] = {7, 61};
+static const int batchBlock = 1024;  // Values pre-filtered (and survivors gathered) per pass
+
+struct Lane32  // Per-value constants: R mod n and n-1 = d*2^s
+{
+	uint64_t n, one, d, s;
+};
+
+struct Lane64  // Per-value constants: n^-1 mod 2^64, R mod n and n-1 = d*2^s
+{
+	uint64_t n, inv, one, d, s;
+};
+
+static inline Lane32 laneSetup (const uint32_t n)
+{
+	Lane32 lane;
+	lane.n = n;
+	lane.one = uint32_t (0 - n) % n;  // 2^32 mod n
+	lane.s = __builtin_ctz(n - 1);
+	lane.d = (n - 1) >> lane.s;
+	return lane;
+}
+
+static inline Lane64 laneSetup64 (const uint64_t n)
+{
+	Lane64 lane;
+	lane.n = n;
+	lane.inv = n;  // Correct to 3 bits for odd n; each Newton step doubles that
+	for (int i = 0; i < 5; ++i) lane.inv *= 2 - n * lane.inv;
+	lane.one = (0 - n) % n;  // 2^64 mod n
+	lane.s = __builtin_ctzll(n - 1);
+	lane.d = (n - 1) >> lane.s;
+	return lane;
+}
+
+static void millerRabin32Scalar (const uint32_t* values, size_t count, const uint32_t* bases, int nbases, uint8_t* result)
+{
+	for (size_t i = 0; i < count; ++i) {
+		const Lane32 lane = laneSetup(values[i]);
+		const Montgomery mont(lane.n);
+		const uint64_t minus = lane.n - mont.one();
+		bool ok = true;
+		for (int b = 0; b < nbases && ok; ++b) {
+			uint64_t x = mont.power(mont.toForm(bases[b]), lane.d);
+			ok = x == mont.one() || x == minus;
+			for (uint64_t r = 1; r < lane.s && !ok && x != mont.one(); ++r) {
+				x = mont.multiply(x, x);
+				ok = x == minus;
+			}
+		}
+		result[i] = ok;
+	}
+}
+
+static void strongBase2Scalar (const uint64_t* values, size_t count, uint8_t* result)
+{
+	for (size_t i = 0; i < count; ++i) {
+		const Lane64 lane = laneSetup64(values[i]);
+		const Montgomery mont(lane.n);
+		const uint64_t minus = lane.n - mont.one();
+		uint64_t x = mont.powerOfTwo(lane.d);
+		bool ok = x == mont.one() || x == minus;
+		for (uint64_t r = 1; r < lane.s && !ok && x != mont.one(); ++r) {
+			x = mont.multiply(x, x);
+			ok = x == minus;
+		}
+		result[i] = ok;
+	}
+}
+
+#ifdef PRIMES_X86
+
+// One vector of lanes: n, n^-1 mod R (2^32, or 2^64 in the wide kernels), R mod n, -R mod n, d and s
+struct Lanes4
+{
+	__m256i n, inv, one, minus, d, s;
+};
+
+struct Lanes8
+{
+	__m512i n, inv, one, minus, d, s;
+};
+
+__attribute__((target("avx2")))
+static inline __m256i montMultiply4 (const __m256i a, const __m256i b, const __m256i n, const __m256i inv)
+{
+	const __m256i t = _mm256_mul_epu32(a, b);
+	const __m256i mn = _mm256_mul_epu32(_mm256_mul_epu32(t, inv), n);  // m = t*inv mod 2^32, then m*n
+	const __m256i th = _mm256_srli_epi64(t, 32), mh = _mm256_srli_epi64(mn, 32);
+	const __m256i r = _mm256_sub_epi64(th, mh);
+	return _mm256_add_epi64(r, _mm256_and_si256(_mm256_cmpgt_epi64(mh, th), n));  // Values are < 2^32, signed compare is safe
+}
+
+__attribute__((target("avx2")))
+static inline __m256i addMod4 (const __m256i a, const __m256i b, const __m256i n)
+{
+	const __m256i s = _mm256_add_epi64(a, b);
+	return _mm256_blendv_epi8(_mm256_sub_epi64(s, n), s, _mm256_cmpgt_epi64(n, s));
+}
+
+__attribute__((target("avx2")))
+static inline Lanes4 loadLanes4 (const uint32_t* values, size_t count, uint64_t& maxD, uint64_t& maxS)
+{
+	alignas(32) uint64_t n[4], one[4], d[4], s[4];
+	for (size_t l = 0; l < 4; ++l) {
+		const Lane32 lane = laneSetup(l < count ? values[l] : 4099);  // Unused lanes hold a prime
+		n[l] = lane.n, one[l] = lane.one, d[l] = lane.d, s[l] = lane.s;
+		maxD = max(maxD, lane.d);
+		maxS = max(maxS, lane.s);
+	}
+	Lanes4 g;
+	g.n = _mm256_load_si256((const __m256i*) n);
+	g.one = _mm256_load_si256((const __m256i*) one);
+	g.d = _mm256_load_si256((const __m256i*) d);
+	g.s = _mm256_load_si256((const __m256i*) s);
+	g.minus = _mm256_sub_epi64(g.n, g.one);
+	const __m256i two = _mm256_set1_epi64x(2);
+	g.inv = g.n;  // n^-1 mod 2^32 by Newton's iteration, 3 correct bits doubling each step
+	for (int i = 0; i < 4; ++i) g.inv = _mm256_mul_epu32(g.inv, _mm256_sub_epi64(two, _mm256_mul_epu32(g.n, g.inv)));
+	return g;
+}
+
+__attribute__((target("avx2")))
+static void millerRabin32Avx2 (const uint32_t* values, size_t count, const uint32_t* bases, int nbases, uint8_t* result)
+{
+	const __m256i BIT = _mm256_set1_epi64x(1);
+	for (size_t i = 0; i < count; i += 8) {
+		uint64_t maxD = 0, maxS = 0;
+		Lanes4 g[2];
+		for (int k = 0; k < 2; ++k) {
+			g[k] = loadLanes4(values + i + 4 * k, count > i + 4 * k ? count - i - 4 * k : 0, maxD, maxS);
+		}
+		const int topBit = 63 - __builtin_clzll(maxD);
+
+		__m256i ok[2] = {_mm256_set1_epi64x(-1), _mm256_set1_epi64x(-1)};
+		for (int b = 0; b < nbases; ++b) {
+			__m256i x[2], p[2], pass[2];
+			for (int k = 0; k < 2; ++k) {
+				p[k] = _mm256_setzero_si256();  // base * R mod n, by doubling and adding R
+				for (int bit = 31 - __builtin_clz(bases[b]); bit >= 0; --bit) {
+					p[k] = addMod4(p[k], p[k], g[k].n);
+					if ((bases[b] >> bit) & 1) p[k] = addMod4(p[k], g[k].one, g[k].n);
+				}
+				x[k] = g[k].one;
+			}
+			// Right to left: the product and the squaring of each step are independent
+			for (int bit = 0; bit <= topBit; ++bit) {
+				for (int k = 0; k < 2; ++k) {
+					const __m256i y = montMultiply4(x[k], p[k], g[k].n, g[k].inv);
+					const __m256i set = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_srl_epi64(g[k].d, _mm_cvtsi32_si128(bit)), BIT), BIT);
+					x[k] = _mm256_blendv_epi8(x[k], y, set);
+					p[k] = montMultiply4(p[k], p[k], g[k].n, g[k].inv);
+				}
+			}
+			for (int k = 0; k < 2; ++k) {
+				pass[k] = _mm256_or_si256(_mm256_cmpeq_epi64(x[k], g[k].one), _mm256_cmpeq_epi64(x[k], g[k].minus));
+			}
+			for (uint64_t r = 1; r < maxS; ++r) {
+				for (int k = 0; k < 2; ++k) {
+					x[k] = montMultiply4(x[k], x[k], g[k].n, g[k].inv);
+					const __m256i active = _mm256_cmpgt_epi64(g[k].s, _mm256_set1_epi64x((long long) r));
+					pass[k] = _mm256_or_si256(pass[k], _mm256_and_si256(active, _mm256_cmpeq_epi64(x[k], g[k].minus)));
+				}
+			}
+			for (int k = 0; k < 2; ++k) {
+				ok[k] = _mm256_and_si256(ok[k], pass[k]);
+			}
+		}
+		for (int k = 0; k < 2; ++k) {
+			const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(ok[k]));
+			for (size_t l = 0; l < 4 && i + 4 * k + l < count; ++l) {
+				result[i + 4 * k + l] = (mask >> l) & 1;
+			}
+		}
+	}
+}
+
+__attribute__((target("avx2")))
+static inline __m256i lessThan4 (const __m256i a, const __m256i b)  // Unsigned, all ones where a < b
+{
+	const __m256i sign = _mm256_set1_epi64x((long long) (1ULL << 63));
+	return _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+}
+
+__attribute__((target("avx2")))
+static inline void multiplyFull4 (const __m256i a, const __m256i b, __m256i& hi, __m256i& lo)
+{
+	// a*b from the four 32x32 products of the halves; mid collects what carries across bit 64 (at most 34 bits)
+	const __m256i low = _mm256_set1_epi64x(0xFFFFFFFF);
+	const __m256i ah = _mm256_srli_epi64(a, 32), bh = _mm256_srli_epi64(b, 32);
+	const __m256i ll = _mm256_mul_epu32(a, b), lh = _mm256_mul_epu32(a, bh), hl = _mm256_mul_epu32(ah, b), hh = _mm256_mul_epu32(ah, bh);
+	const __m256i mid = _mm256_add_epi64(_mm256_add_epi64(_mm256_srli_epi64(ll, 32), _mm256_and_si256(lh, low)), _mm256_and_si256(hl, low));
+	lo = _mm256_or_si256(_mm256_and_si256(ll, low), _mm256_slli_epi64(mid, 32));
+	hi = _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(mid, 32)), _mm256_add_epi64(_mm256_srli_epi64(lh, 32), _mm256_srli_epi64(hl, 32)));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i montMultiplyWide4 (const __m256i a, const __m256i b, const __m256i n, const __m256i inv)
+{
+	__m256i hi, lo, mh, ml;
+	multiplyFull4(a, b, hi, lo);
+	const __m256i loh = _mm256_srli_epi64(lo, 32), invh = _mm256_srli_epi64(inv, 32);  // m = lo*inv mod 2^64
+	const __m256i m = _mm256_add_epi64(_mm256_mul_epu32(lo, inv), _mm256_slli_epi64(_mm256_add_epi64(_mm256_mul_epu32(lo, invh), _mm256_mul_epu32(loh, inv)), 32));
+	multiplyFull4(m, n, mh, ml);
+	return _mm256_add_epi64(_mm256_sub_epi64(hi, mh), _mm256_and_si256(lessThan4(hi, mh), n));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i addModWide4 (const __m256i a, const __m256i b, const __m256i n)
+{
+	const __m256i s = _mm256_add_epi64(a, b);  // May wrap when n > 2^63
+	const __m256i over = _mm256_or_si256(lessThan4(s, a), _mm256_xor_si256(lessThan4(s, n), _mm256_set1_epi64x(-1)));
+	return _mm256_sub_epi64(s, _mm256_and_si256(over, n));
+}
+
+__attribute__((target("avx2")))
+static inline Lanes4 loadWideLanes4 (const uint64_t* values, size_t count, uint64_t& maxD, uint64_t& maxS)
+{
+	alignas(32) uint64_t n[4], inv[4], one[4], d[4], s[4];
+	for (size_t l = 0; l < 4; ++l) {
+		const Lane64 lane = laneSetup64(l < count ? values[l] : 4099);  // Unused lanes hold a prime
+		n[l] = lane.n, inv[l] = lane.inv, one[l] = lane.one, d[l] = lane.d, s[l] = lane.s;
+		maxD = max(maxD, lane.d);
+		maxS = max(maxS, lane.s);
+	}
+	Lanes4 g;
+	g.n = _mm256_load_si256((const __m256i*) n);
+	g.inv = _mm256_load_si256((const __m256i*) inv);
+	g.one = _mm256_load_si256((const __m256i*) one);
+	g.d = _mm256_load_si256((const __m256i*) d);
+	g.s = _mm256_load_si256((const __m256i*) s);
+	g.minus = _mm256_sub_epi64(g.n, g.one);
+	return g;
+}
+
+__attribute__((target("avx2")))
+static void strongBase2Avx2 (const uint64_t* values, size_t count, uint8_t* result)
+{
+	for (size_t i = 0; i < count; i += 8) {
+		uint64_t maxD = 0, maxS = 0;
+		Lanes4 g[2];
+		for (int k = 0; k < 2; ++k) {
+			g[k] = loadWideLanes4(values + i + 4 * k, count > i + 4 * k ? count - i - 4 * k : 0, maxD, maxS);
+		}
+
+		// Left to right from 1: square, then double the lanes whose bit is set (a lane's leading zeros keep it at 1)
+		__m256i x[2] = {g[0].one, g[1].one}, pass[2];
+		for (int bit = 63 - __builtin_clzll(maxD); bit >= 0; --bit) {
+			const __m256i mask = _mm256_set1_epi64x(1LL << bit);
+			for (int k = 0; k < 2; ++k) {
+				x[k] = montMultiplyWide4(x[k], x[k], g[k].n, g[k].inv);
+				const __m256i set = _mm256_cmpeq_epi64(_mm256_and_si256(g[k].d, mask), mask);
+				x[k] = _mm256_blendv_epi8(x[k], addModWide4(x[k], x[k], g[k].n), set);
+			}
+		}
+		for (int k = 0; k < 2; ++k) {
+			pass[k] = _mm256_or_si256(_mm256_cmpeq_epi64(x[k], g[k].one), _mm256_cmpeq_epi64(x[k], g[k].minus));
+		}
+		for (uint64_t r = 1; r < maxS; ++r) {
+			for (int k = 0; k < 2; ++k) {
+				x[k] = montMultiplyWide4(x[k], x[k], g[k].n, g[k].inv);
+				const __m256i active = _mm256_cmpgt_epi64(g[k].s, _mm256_set1_epi64x((long long) r));
+				pass[k] = _mm256_or_si256(pass[k], _mm256_and_si256(active, _mm256_cmpeq_epi64(x[k], g[k].minus)));
+			}
+		}
+		for (int k = 0; k < 2; ++k) {
+			const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(pass[k]));
+			for (size_t l = 0; l < 4 && i + 4 * k + l < count; ++l) {
+				result[i + 4 * k + l] = (mask >> l) & 1;
+			}
+		}
+	}
+}
+
+__attribute__((target("avx512f")))
+static inline __m512i montMultiply8 (const __m512i a, const __m512i b, const __m512i n, const __m512i inv)
+{
+	const __m512i t = _mm512_mul_epu32(a, b);
+	const __m512i mn = _mm512_mul_epu32(_mm512_mul_epu32(t, inv), n);
+	const __m512i th = _mm512_srli_epi64(t, 32), mh = _mm512_srli_epi64(mn, 32);
+	const __m512i r = _mm512_sub_epi64(th, mh);
+	return _mm512_mask_add_epi64(r, _mm512_cmplt_epu64_mask(th, mh), r, n);
+}
+
+__attribute__((target("avx512f")))
+static inline __m512i addMod8 (const __m512i a, const __m512i b, const __m512i n)
+{
+	const __m512i s = _mm512_add_epi64(a, b);
+	return _mm512_mask_sub_epi64(s, _mm512_cmpge_epu64_mask(s, n), s, n);
+}
+
+__attribute__((target("avx512f")))
+static inline Lanes8 loadLanes8 (const uint32_t* values, size_t count, uint64_t& maxD, uint64_t& maxS)
+{
+	alignas(64) uint64_t n[8], one[8], d[8], s[8];
+	for (size_t l = 0; l < 8; ++l) {
+		const Lane32 lane = laneSetup(l < count ? values[l] : 4099);  // Unused lanes hold a prime
+		n[l] = lane.n, one[l] = lane.one, d[l] = lane.d, s[l] = lane.s;
+		maxD = max(maxD, lane.d);
+		maxS = max(maxS, lane.s);
+	}
+	Lanes8 g;
+	g.n = _mm512_load_si512(n);
+	g.one = _mm512_load_si512(one);
+	g.d = _mm512_load_si512(d);
+	g.s = _mm512_load_si512(s);
+	g.minus = _mm512_sub_epi64(g.n, g.one);
+	const __m512i two = _mm512_set1_epi64(2);
+	g.inv = g.n;
+	for (int i = 0; i < 4; ++i) g.inv = _mm512_mul_epu32(g.inv, _mm512_sub_epi64(two, _mm512_mul_epu32(g.n, g.inv)));
+	return g;
+}
+
+__attribute__((target("avx512f")))
+static void millerRabin32Avx512 (const uint32_t* values, size_t count, const uint32_t* bases, int nbases, uint8_t* result)
+{
+	for (size_t i = 0; i < count; i += 16) {
+		uint64_t maxD = 0, maxS = 0;
+		Lanes8 g[2];
+		for (int k = 0; k < 2; ++k) {
+			g[k] = loadLanes8(values + i + 8 * k, count > i + 8 * k ? count - i - 8 * k : 0, maxD, maxS);
+		}
+		const int topBit = 63 - __builtin_clzll(maxD);
+
+		__mmask8 ok[2] = {0xFF, 0xFF};
+		for (int b = 0; b < nbases; ++b) {
+			__m512i x[2], p[2];
+			__mmask8 pass[2];
+			for (int k = 0; k < 2; ++k) {
+				p[k] = _mm512_setzero_si512();  // base * R mod n, by doubling and adding R
+				for (int bit = 31 - __builtin_clz(bases[b]); bit >= 0; --bit) {
+					p[k] = addMod8(p[k], p[k], g[k].n);
+					if ((bases[b] >> bit) & 1) p[k] = addMod8(p[k], g[k].one, g[k].n);
+				}
+				x[k] = g[k].one;
+			}
+			// Right to left: the product and the squaring of each step are independent
+			for (int bit = 0; bit <= topBit; ++bit) {
+				const __m512i mask = _mm512_set1_epi64(1LL << bit);
+				for (int k = 0; k < 2; ++k) {
+					const __m512i y = montMultiply8(x[k], p[k], g[k].n, g[k].inv);
+					x[k] = _mm512_mask_mov_epi64(x[k], _mm512_test_epi64_mask(g[k].d, mask), y);
+					p[k] = montMultiply8(p[k], p[k], g[k].n, g[k].inv);
+				}
+			}
+			for (int k = 0; k < 2; ++k) {
+				pass[k] = _mm512_cmpeq_epu64_mask(x[k], g[k].one) | _mm512_cmpeq_epu64_mask(x[k], g[k].minus);
+			}
+			for (uint64_t r = 1; r < maxS; ++r) {
+				const __m512i round = _mm512_set1_epi64((long long) r);
+				for (int k = 0; k < 2; ++k) {
+					x[k] = montMultiply8(x[k], x[k], g[k].n, g[k].inv);
+					pass[k] |= _mm512_mask_cmpeq_epu64_mask(_mm512_cmpgt_epu64_mask(g[k].s, round), x[k], g[k].minus);
+				}
+			}
+			for (int k = 0; k < 2; ++k) {
+				ok[k] &= pass[k];
+			}
+		}
+		for (int k = 0; k < 2; ++k) {
+			for (size_t l = 0; l < 8 && i + 8 * k + l < count; ++l) {
+				result[i + 8 * k + l] = (ok[k] >> l) & 1;
+			}
+		}
+	}
+}
+
+__attribute__((target("avx512f")))
+static inline void multiplyFull8 (const __m512i a, const __m512i b, __m512i& hi, __m512i& lo)
+{
+	const __m512i low = _mm512_set1_epi64(0xFFFFFFFF);
+	const __m512i ah = _mm512_srli_epi64(a, 32), bh = _mm512_srli_epi64(b, 32);
+	const __m512i ll = _mm512_mul_epu32(a, b), lh = _mm512_mul_epu32(a, bh), hl = _mm512_mul_epu32(ah, b), hh = _mm512_mul_epu32(ah, bh);
+	const __m512i mid = _mm512_add_epi64(_mm512_add_epi64(_mm512_srli_epi64(ll, 32), _mm512_and_si512(lh, low)), _mm512_and_si512(hl, low));
+	lo = _mm512_or_si512(_mm512_and_si512(ll, low), _mm512_slli_epi64(mid, 32));
+	hi = _mm512_add_epi64(_mm512_add_epi64(hh, _mm512_srli_epi64(mid, 32)), _mm512_add_epi64(_mm512_srli_epi64(lh, 32), _mm512_srli_epi64(hl, 32)));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512i montMultiplyWide8 (const __m512i a, const __m512i b, const __m512i n, const __m512i inv)
+{
+	__m512i hi, lo, mh, ml;
+	multiplyFull8(a, b, hi, lo);
+	const __m512i loh = _mm512_srli_epi64(lo, 32), invh = _mm512_srli_epi64(inv, 32);  // m = lo*inv mod 2^64
+	const __m512i m = _mm512_add_epi64(_mm512_mul_epu32(lo, inv), _mm512_slli_epi64(_mm512_add_epi64(_mm512_mul_epu32(lo, invh), _mm512_mul_epu32(loh, inv)), 32));
+	multiplyFull8(m, n, mh, ml);
+	const __m512i r = _mm512_sub_epi64(hi, mh);
+	return _mm512_mask_add_epi64(r, _mm512_cmplt_epu64_mask(hi, mh), r, n);
+}
+
+__attribute__((target("avx512f")))
+static inline __m512i addModWide8 (const __m512i a, const __m512i b, const __m512i n)
+{
+	const __m512i s = _mm512_add_epi64(a, b);  // May wrap when n > 2^63
+	return _mm512_mask_sub_epi64(s, _mm512_cmplt_epu64_mask(s, a) | _mm512_cmpge_epu64_mask(s, n), s, n);
+}
+
+__attribute__((target("avx512f")))
+static inline Lanes8 loadWideLanes8 (const uint64_t* values, size_t count, uint64_t& maxD, uint64_t& maxS)
+{
+	alignas(64) uint64_t n[8], inv[8], one[8], d[8], s[8];
+	for (size_t l = 0; l < 8; ++l) {
+		const Lane64 lane = laneSetup64(l < count ? values[l] : 4099);  // Unused lanes hold a prime
+		n[l] = lane.n, inv[l] = lane.inv, one[l] = lane.one, d[l] = lane.d, s[l] = lane.s;
+		maxD = max(maxD, lane.d);
+		maxS = max(maxS, lane.s);
+	}
+	Lanes8 g;
+	g.n = _mm512_load_si512(n);
+	g.inv = _mm512_load_si512(inv);
+	g.one = _mm512_load_si512(one);
+	g.d = _mm512_load_si512(d);
+	g.s = _mm512_load_si512(s);
+	g.minus = _mm512_sub_epi64(g.n, g.one);
+	return g;
+}
+
+__attribute__((target("avx512f")))
+static void strongBase2Avx512 (const uint64_t* values, size_t count, uint8_t* result)
+{
+	for (size_t i = 0; i < count; i += 16) {
+		uint64_t maxD = 0, maxS = 0;
+		Lanes8 g[2];
+		for (int k = 0; k < 2; ++k) {
+			g[k] = loadWideLanes8(values + i + 8 * k, count > i + 8 * k ? count - i - 8 * k : 0, maxD, maxS);
+		}
+
+		// Left to right from 1: square, then double the lanes whose bit is set
+		__m512i x[2] = {g[0].one, g[1].one};
+		__mmask8 pass[2];
+		for (int bit = 63 - __builtin_clzll(maxD); bit >= 0; --bit) {
+			const __m512i mask = _mm512_set1_epi64(1LL << bit);
+			for (int k = 0; k < 2; ++k) {
+				x[k] = montMultiplyWide8(x[k], x[k], g[k].n, g[k].inv);
+				x[k] = _mm512_mask_mov_epi64(x[k], _mm512_test_epi64_mask(g[k].d, mask), addModWide8(x[k], x[k], g[k].n));
+			}
+		}
+		for (int k = 0; k < 2; ++k) {
+			pass[k] = _mm512_cmpeq_epu64_mask(x[k], g[k].one) | _mm512_cmpeq_epu64_mask(x[k], g[k].minus);
+		}
+		for (uint64_t r = 1; r < maxS; ++r) {
+			const __m512i round = _mm512_set1_epi64((long long) r);
+			for (int k = 0; k < 2; ++k) {
+				x[k] = montMultiplyWide8(x[k], x[k], g[k].n, g[k].inv);
+				pass[k] |= _mm512_mask_cmpeq_epu64_mask(_mm512_cmpgt_epu64_mask(g[k].s, round), x[k], g[k].minus);
+			}
+		}
+		for (int k = 0; k < 2; ++k) {
+			for (size_t l = 0; l < 8 && i + 8 * k + l < count; ++l) {
+				result[i + 8 * k + l] = (pass[k] >> l) & 1;
+			}
+		}
+	}
+}
+
+#endif
+
+static BatchKernel chooseKernel (const char*& name, WideKernel& wide)
+{
+#ifdef PRIMES_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) {
+		name = "avx512";
+		wide = strongBase2Avx512;
+		return millerRabin32Avx512;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		name = "avx2";
+		wide = strongBase2Avx2;
+		return millerRabin32Avx2;
+	}
+#endif
+	name = "scalar";
+	wide = strongBase2Scalar;
+	return millerRabin32Scalar;
+}
+
+static const char* kernelName = "scalar";
+static WideKernel wideKernel = strongBase2Scalar;
+static const BatchKernel batchKernel = chooseKernel(kernelName, wideKernel);
+
+const char* Primes::batchKernelName ()
+{
+	return kernelName;
+}
+
+void Primes::isPrimeBatch (const uint64_t* values, const size_t count, uint8_t* out)
+{
+	uint32_t candidates[batchBlock];
+	uint32_t where[batchBlock];
+	uint8_t verdicts[batchBlock];
+	uint64_t wide[batchBlock];
+	uint32_t whereWide[batchBlock];
+
+	for (size_t start = 0; start < count; start += batchBlock) {
+		const size_t end = min(count, start + size_t (batchBlock));
+		int gathered = 0, gatheredWide = 0;
+		for (size_t i = start; i < end; ++i) {
+			const uint64_t n = values[i];
+			if (n < 4) {
+				out[i] = n == 2 || n == 3;
+				continue;
+			}
+			bool decided = false;
+			for (int p = 0; p < Primes::lowPrimes.size && Primes::lowPrimes.primes[p] < 64; ++p) {
+				if (Primes::lowPrimes.divides(p, n)) {
+					out[i] = n == Primes::lowPrimes.primes[p];
+					decided = true;
+					break;
+				}
+			}
+			if (decided) {
+				continue;
+			} else if (n < 64 * 64) {
+				out[i] = 1;
+			} else if (n >> 32) {
+				wide[gatheredWide] = n;
+				whereWide[gatheredWide++] = uint32_t (i - start);
+			} else {
+				candidates[gathered] = uint32_t (n);
+				where[gathered++] = uint32_t (i - start);
+			}
+		}
+		// Base 2 on every survivor, then bases 7 and 61 on the ones that pass it
+		batchKernel(candidates, size_t (gathered), firstBase, 1, verdicts);
+		int passed = 0;
+		for (int k = 0; k < gathered; ++k) {
+			if (verdicts[k]) {
+				candidates[passed] = candidates[k];
+				where[passed++] = where[k];
+			} else {
+				out[start + where[k]] = 0;
+			}
+		}
+		batchKernel(candidates, size_t (passed), otherBases, 2, verdicts);
+		for (int k = 0; k < passed; ++k) {
+			out[start + where[k]] = verdicts[k];
+		}
+		// Wider values: base 2 in lanes, then what isPrime64 does after it on the ones that pass
+		wideKernel(wide, size_t (gatheredWide), verdicts);
+		for (int k = 0; k < gatheredWide; ++k) {
+			out[start + whereWide[k]] = verdicts[k] && ! Primes::isSquare(wide[k]) && Primes::strongLucasProbablePrime(Montgomery(wide[k]));
+		}
+	}
+}
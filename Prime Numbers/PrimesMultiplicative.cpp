@@ -0,0 +1,116 @@
+#include <algorithm>  // func: std::min()
+#include <cassert>  // func: assert()
+#include <cstdint>  // Type: int8_t, uint8_t, uint32_t, uint64_t
+#include <vector>  // Type: std::vector
+
+#include "Parallel.h"
+#include "Primes.h"
+#include "Sieve.h"
+#include "StaticPrimes.h"
+
+using namespace std;
+
+static const long multiplicativeSpan = 1L << 15;  // Numbers per segment: the cofactor array stays in L2
+
+void Primes::multiplicativeRange (const long lo, const long hi, uint64_t* phi, int8_t* mu, uint64_t* sigma, uint8_t* omega, const int threads)
+{
+	assert (lo >= 1);
+	if (hi < lo) {
+		return;
+	}
+	// Odd primes up to sqrt(hi) with their inverses mod 2^64, so exponents are found by multiplications only
+	const vector<uint32_t> primes = Sieve::smallPrimes(uint32_t (Sieve::isqrt(hi)));
+	vector<uint32_t> odd;
+	vector<uint64_t> inverses;
+	for (size_t k = 0; k < primes.size(); ++k) {
+		if (primes[k] != 2) {
+			odd.push_back(primes[k]);
+			inverses.push_back(StaticPrimes::inverse(primes[k]));
+		}
+	}
+
+	const long segments = (hi - lo) / multiplicativeSpan + 1;
+	const int workers = Parallel::threadCount(threads);
+	vector<vector<uint64_t> > rems(workers, vector<uint64_t>(multiplicativeSpan));
+	Parallel::forRange(segments, workers, [&](long t, int w) {
+		const long s = lo + t * multiplicativeSpan;
+		Primes::multiplicativeSegment(s, min(hi, s + multiplicativeSpan - 1), s - lo, odd, inverses, rems[w], phi, mu, sigma, omega);
+	});
+}
+
+void Primes::multiplicativeSegment (const long lo, const long hi, const long first, const vector<uint32_t>& primes, const vector<uint64_t>& inverses,
+	vector<uint64_t>& rem, uint64_t* phi, int8_t* mu, uint64_t* sigma, uint8_t* omega)
+{
+	const long length = hi - lo + 1;
+	if (phi) phi += first;
+	if (mu) mu += first;
+	if (sigma) sigma += first;
+	if (omega) omega += first;
+	for (long i = 0; i < length; ++i) {
+		rem[i] = uint64_t (lo + i);  // The part of lo + i not yet accounted for
+		if (phi) phi[i] = 1;
+		if (mu) mu[i] = 1;
+		if (sigma) sigma[i] = 1;
+		if (omega) omega[i] = 0;
+	}
+
+	// Every number is visited once per prime p <= sqrt(hi) that divides it; the exponent e comes from exact divisions
+	for (long i = lo % 2; i < length; i += 2) {
+		const int e = __builtin_ctzll(rem[i]);
+		rem[i] >>= e;
+		if (phi) phi[i] = uint64_t (1) << (e - 1);
+		if (mu) mu[i] = e > 1 ? 0 : -1;
+		if (sigma) sigma[i] = (uint64_t (2) << e) - 1;
+		if (omega) omega[i] = 1;
+	}
+	for (size_t k = 0; k < primes.size(); ++k) {
+		const uint64_t p = primes[k], inv = inverses[k], limit = UINT64_MAX / p;
+		if (long (p * p) > hi) break;
+		for (long i = long ((uint64_t (lo) + p - 1) / p * p) - lo; i < length; i += long (p)) {
+			uint64_t r = rem[i] * inv, below = 1, pk = p, sum = 1 + p;  // r = rem / p; pk = p^e, below = p^(e-1); sum = 1 + p + ... + p^e
+			int e = 1;
+			while (r * inv <= limit) {
+				r *= inv;
+				below = pk;
+				pk *= p;
+				sum += pk;
+				e++;
+			}
+			rem[i] = r;
+			if (phi) phi[i] *= pk - below;
+			if (mu) mu[i] = e > 1 ? 0 : -mu[i];
+			if (sigma) sigma[i] *= sum;
+			if (omega) omega[i] += 1;
+		}
+	}
+
+	// What is left is 1 or a single prime above sqrt(hi); about half the numbers have one, so no branch on it
+	for (long i = 0; i < length; ++i) {
+		const uint64_t q = rem[i];
+		const bool prime = q > 1;
+		if (phi) phi[i] *= prime ? q - 1 : 1;
+		if (mu) mu[i] = int8_t (prime ? -mu[i] : mu[i]);
+		if (sigma) sigma[i] *= prime ? q + 1 : 1;
+		if (omega) omega[i] += prime;
+	}
+}
+
+void Primes::totientRange (const long lo, const long hi, uint64_t* out, const int threads)
+{
+	Primes::multiplicativeRange(lo, hi, out, nullptr, nullptr, nullptr, threads);
+}
+
+void Primes::mobiusRange (const long lo, const long hi, int8_t* out, const int threads)
+{
+	Primes::multiplicativeRange(lo, hi, nullptr, out, nullptr, nullptr, threads);
+}
+
+void Primes::divisorSumRange (const long lo, const long hi, uint64_t* out, const int threads)
+{
+	Primes::multiplicativeRange(lo, hi, nullptr, nullptr, out, nullptr, threads);
+}
+
+void Primes::distinctFactorsRange (const long lo, const long hi, uint8_t* out, const int threads)
+{
+	Primes::multiplicativeRange(lo, hi, nullptr, nullptr, nullptr, out, threads);
+}
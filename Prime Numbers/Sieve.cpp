@@ -0,0 +1,179 @@
+#include <algorithm>  // func: std::min(), std::max()
+#include <cassert>  // func: assert()
+#include <cmath>  // func: std::sqrt()
+#include <cstdint>  // Type: uint32_t, uint64_t
+#include <vector>  // Type: std::vector
+
+#include "Sieve.h"
+
+using namespace std;
+
+// The pre-sieve pattern covers the odd numbers 2k+1 for k in [0, 3*5*7*11*13)
+static const int presieveCount = 5;
+static const uint32_t presievePrimes[presieveCount] = {3, 5, 7, 11, 13};
+static const long presievePeriod = 3 * 5 * 7 * 11 * 13;
+
+Sieve::Sieve (long limit, bool presieve)
+{
+	assert (limit >= 0);
+	Sieve::limit = limit;
+	Sieve::presieve = presieve;
+	Sieve::low = 0;
+	Sieve::high = -1;
+	Sieve::nbits = 0;
+	Sieve::hasTwo = false;
+
+	vector<uint32_t> all = Sieve::smallPrimes(uint32_t (Sieve::isqrt(limit)));
+	Sieve::primes.assign(all.begin() + min<size_t>(1, all.size()), all.end());  // 2 is handled by the odd-only layout
+	Sieve::bits.resize(Sieve::segmentBytes / 8);
+}
+
+long Sieve::isqrt (long n)
+{
+	long r = long (sqrt(double (n)));
+	while (r * r > n) --r;
+	while ((r + 1) * (r + 1) <= n) ++r;
+	return r;
+}
+
+vector<uint32_t> Sieve::smallPrimes (uint32_t n)
+{
+	vector<uint32_t> result;
+	if (n < 2) return result;
+	result.push_back(2);
+
+	vector<bool> composite((n + 1) / 2, false);  // index i <=> 2i + 1
+	for (uint64_t i = 1; i < composite.size(); ++i) {
+		if (composite[i]) continue;
+		uint64_t p = 2 * i + 1;
+		result.push_back(uint32_t (p));
+		for (uint64_t j = p * p / 2; j < composite.size(); j += p) {
+			composite[j] = true;
+		}
+	}
+	return result;
+}
+
+const vector<uint64_t>& Sieve::presievePattern ()
+{
+	// Built once; padded by two words so any 64 bits starting below the period can be read directly
+	static const vector<uint64_t> pattern = [] {
+		vector<uint64_t> pat((presievePeriod + 127) / 64 + 1, 0);
+		for (long k = 0; k < long (pat.size()) * 64; ++k) {
+			long n = 2 * (k % presievePeriod) + 1;
+			bool coprime = true;
+			for (int j = 0; j < presieveCount; ++j) {
+				if (n % presievePrimes[j] == 0) {
+					coprime = false;
+					break;
+				}
+			}
+			if (coprime) pat[k / 64] |= uint64_t (1) << (k % 64);
+		}
+		return pat;
+	}();
+	return pattern;
+}
+
+void Sieve::fillPresieved ()
+{
+	const vector<uint64_t>& pat = Sieve::presievePattern();
+	long offset = (Sieve::low / 2) % presievePeriod;
+	for (long w = 0; w * 64 < Sieve::nbits; ++w) {
+		long word = offset >> 6, shift = offset & 63;
+		Sieve::bits[w] = shift ? (pat[word] >> shift) | (pat[word + 1] << (64 - shift)) : pat[word];
+		offset += 64;
+		if (offset >= presievePeriod) offset -= presievePeriod;
+	}
+	// The pattern crossed off the pre-sieved primes themselves
+	for (int j = 0; j < presieveCount; ++j) {
+		long q = presievePrimes[j];
+		if (q > Sieve::low && q <= Sieve::high) {
+			long i = (q - Sieve::low - 1) / 2;
+			Sieve::bits[i / 64] |= uint64_t (1) << (i % 64);
+		}
+	}
+}
+
+long Sieve::segment (long lo, long hi)
+{
+	if (lo < 0) lo = 0;
+	Sieve::low = lo & ~1L;
+	Sieve::high = hi;
+	Sieve::hasTwo = lo <= 2 && hi >= 2;
+	Sieve::nbits = hi >= Sieve::low ? (hi - Sieve::low + 1) / 2 : 0;
+	assert (Sieve::nbits <= Sieve::segmentBytes * 8 && hi <= Sieve::limit);
+	if (Sieve::nbits == 0) return Sieve::hasTwo;
+
+	const long words = (Sieve::nbits + 63) / 64;
+	size_t first = 0;  // First sieving prime not handled by the pre-sieve
+	if (Sieve::presieve) {
+		Sieve::fillPresieved();
+		while (first < Sieve::primes.size() && Sieve::primes[first] <= presievePrimes[presieveCount - 1]) ++first;
+	} else {
+		fill(Sieve::bits.begin(), Sieve::bits.begin() + words, ~uint64_t (0));
+	}
+	if (Sieve::low == 0) Sieve::bits[0] &= ~uint64_t (1);  // 1 is not a prime
+
+	uint64_t* b = Sieve::bits.data();
+	for (size_t k = first; k < Sieve::primes.size(); ++k) {
+		const long p = Sieve::primes[k];
+		if (p * p > hi) break;
+		long m = (Sieve::low + p) / p * p;  // First multiple above low
+		if (m % 2 == 0) m += p;
+		m = max(m, p * p);
+		for (long i = (m - Sieve::low - 1) / 2; i < Sieve::nbits; i += p) {
+			b[i >> 6] &= ~(uint64_t (1) << (i & 63));
+		}
+	}
+	if (Sieve::nbits % 64) b[words - 1] &= (uint64_t (1) << (Sieve::nbits % 64)) - 1;
+
+	long total = Sieve::hasTwo;
+	for (long w = 0; w < words; ++w) {
+		total += __builtin_popcountll(b[w]);
+	}
+	return total;
+}
+
+long Sieve::count (long lo, long hi)
+{
+	long total = 0;
+	for (long s = max(lo, 0L); s <= hi; ) {
+		long e = min(hi, (s & ~1L) + Sieve::segmentSpan - 1);
+		total += Sieve::segment(s, e);
+		if (e == hi) break;
+		s = e + 1;
+	}
+	return total;
+}
+
+long Sieve::nth (long x, long k)
+{
+	long found = 0;
+	if (k > 0) {
+		for (long s = max(x + 1, 0L); s <= Sieve::limit; ) {
+			const long e = min(Sieve::limit, (s & ~1L) + Sieve::segmentSpan - 1);
+			const long c = Sieve::segment(s, e);
+			if (c >= k) {
+				Sieve::forEach([&](long p) { if (--k == 0) found = p; });
+				break;
+			}
+			k -= c;
+			s = e + 1;
+		}
+	} else if (k < 0) {
+		// Downwards a segment at a time; in the segment that holds it, the answer is the (c + k + 1)-th in order
+		for (long e = min(x, Sieve::limit); e >= 2; ) {
+			const long s = max(e - Sieve::segmentSpan + 2, 0L);
+			const long c = Sieve::segment(s, e);
+			if (c >= -k) {
+				long index = c + k + 1;
+				Sieve::forEach([&](long p) { if (--index == 0) found = p; });
+				break;
+			}
+			k += c;
+			e = s - 1;
+		}
+	}
+	return found;
+}
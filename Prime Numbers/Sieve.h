@@ -0,0 +1,51 @@
+#ifndef SIEVE_H
+#define SIEVE_H
+
+#include <cstdint>
+#include <vector>
+
+class Sieve  // Segmented, bit-packed Sieve of Eratosthenes (odd numbers only)
+{
+	private:
+		std::vector<uint32_t> primes;  // Odd sieving primes up to sqrt(limit)
+		std::vector<uint64_t> bits;  // Current segment, bit i <=> low + 2i + 1 (1 = prime)
+		long limit;  // Largest number this sieve can handle
+		long low;  // Even base of the current segment
+		long high;  // Inclusive end of the current segment
+		long nbits;  // Number of valid bits in the current segment
+		bool hasTwo;  // 2 lies in the current segment (2 is not stored in the bitmap)
+		bool presieve;  // Copy a pre-sieved pattern of 3, 5, 7, 11, 13 instead of crossing them off
+
+		void fillPresieved ();
+		static const std::vector<uint64_t>& presievePattern ();
+
+	public:
+		static const long segmentBytes = 32768;  // Bitmap size of one segment, sized to fit L1
+		static const long segmentSpan = segmentBytes * 16;  // Numbers covered by one segment (odd only, 8 bits/byte)
+
+		Sieve (long limit, bool presieve = true);  // Memory is O(sqrt(limit)) for primes plus one segment
+		long segment (long lo, long hi);  // Sieves [lo, hi] (at most segmentSpan numbers) and returns its prime count
+		long count (long lo, long hi);  // Prime count of [lo, hi] of any length, one segment at a time
+		long nth (long x, long k);  // k > 0: the k-th prime above x, k < 0: the -k-th prime at or below x (0 if past the limit or below 2)
+		long getLimit () const { return limit; }
+
+		template <class F> void forEach (F f) const;  // Calls f(p) for every prime of the last sieved segment, in order
+
+		static std::vector<uint32_t> smallPrimes (uint32_t n);  // Simple (unsegmented) sieve: all primes <= n
+		static long isqrt (long n);  // floor(sqrt(n)) without floating point rounding errors
+};
+
+template <class F>
+void Sieve::forEach (F f) const
+{
+	if (hasTwo) f(2L);
+	for (long w = 0; w * 64 < nbits; ++w) {
+		uint64_t word = bits[w];
+		while (word) {
+			f(low + 2 * (w * 64 + __builtin_ctzll(word)) + 1);
+			word &= word - 1;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef STATICPRIMES_H
+#define STATICPRIMES_H
+
+#include <cstdint>
+
+#ifndef PRIMES_LOW_BOUND
+#define PRIMES_LOW_BOUND 1000  // Primes::lowPrimes holds every prime below this (-DPRIMES_LOW_BOUND=n, above 64)
+#endif
+
+class StaticPrimes  // [Static] Namespace Class of constexpr prime arithmetic: usable in static_assert, array bounds and tables
+{
+	private:
+		static constexpr uint64_t mulmod (const uint64_t a, const uint64_t b, const uint64_t n) { return uint64_t ((unsigned __int128) a * b % n); }
+		static constexpr uint64_t powmod (uint64_t a, uint64_t e, const uint64_t n);
+		static constexpr bool strongProbablePrime (const uint64_t n, const uint64_t a);
+
+	public:
+		static constexpr bool isPrime (const uint64_t n);  // Deterministic Miller-Rabin, exact for every 64-bit n
+		static constexpr uint64_t smallestFactor (const uint64_t n);  // Trial division, O(sqrt(p)) steps: meant for small constants
+		static constexpr uint64_t nextPrime (uint64_t n);  // Smallest prime > n
+		static constexpr int count (const uint64_t n);  // Number of primes below n
+		static constexpr uint64_t gcd (uint64_t a, uint64_t b);
+		static constexpr int totient (const int m);
+		static constexpr uint64_t inverse (const uint64_t a);  // a^-1 mod 2^64, a odd
+};
+
+constexpr uint64_t StaticPrimes::powmod (uint64_t a, uint64_t e, const uint64_t n)
+{
+	uint64_t result = 1 % n;
+	a %= n;
+	while (e) {
+		if (e & 1) result = mulmod(result, a, n);
+		a = mulmod(a, a, n);
+		e >>= 1;
+	}
+	return result;
+}
+
+constexpr bool StaticPrimes::strongProbablePrime (const uint64_t n, const uint64_t a)
+{
+	if (a % n == 0) {
+		return true;
+	}
+	uint64_t d = n - 1;
+	int s = 0;
+	while (d % 2 == 0) {
+		d /= 2;
+		s++;
+	}
+	uint64_t x = powmod(a, d, n);
+	if (x == 1 || x == n - 1) {
+		return true;
+	}
+	for (int r = 1; r < s; ++r) {
+		x = mulmod(x, x, n);
+		if (x == n - 1) {
+			return true;
+		}
+	}
+	return false;
+}
+
+constexpr bool StaticPrimes::isPrime (const uint64_t n)
+{
+	if (n < 4) {
+		return n == 2 || n == 3;
+	}
+	if (n % 2 == 0 || n % 3 == 0) {
+		return false;
+	}
+	// These seven bases leave no strong pseudoprime below 2^64
+	const uint64_t bases[7] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+	for (int i = 0; i < 7; ++i) {
+		if (! strongProbablePrime(n, bases[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+constexpr uint64_t StaticPrimes::smallestFactor (const uint64_t n)
+{
+	if (n % 2 == 0) {
+		return 2;
+	}
+	for (uint64_t p = 3; p <= n / p; p += 2) {
+		if (n % p == 0) {
+			return p;
+		}
+	}
+	return n;
+}
+
+constexpr uint64_t StaticPrimes::nextPrime (uint64_t n)
+{
+	do {
+		n++;
+	} while (! isPrime(n));
+	return n;
+}
+
+constexpr int StaticPrimes::count (const uint64_t n)
+{
+	int total = 0;
+	for (uint64_t k = 2; k < n; ++k) {
+		total += isPrime(k);
+	}
+	return total;
+}
+
+constexpr uint64_t StaticPrimes::gcd (uint64_t a, uint64_t b)
+{
+	while (b) {
+		const uint64_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+constexpr int StaticPrimes::totient (const int m)
+{
+	int total = 0;
+	for (int r = 1; r <= m; ++r) {
+		total += gcd(uint64_t (r), uint64_t (m)) == 1;
+	}
+	return total;
+}
+
+constexpr uint64_t StaticPrimes::inverse (const uint64_t a)
+{
+	uint64_t x = a;  // Correct to 3 bits for odd a; each Newton step doubles that
+	for (int i = 0; i < 5; ++i) x *= 2 - a * x;
+	return x;
+}
+
+template <int Bound>
+struct PrimeTable  // Every prime below Bound in a contiguous array, with constants for division-free divisibility tests
+{
+	static constexpr int size = StaticPrimes::count(Bound);
+	static constexpr uint32_t next = uint32_t (StaticPrimes::nextPrime(Bound - 1));  // Smallest prime not in the table
+
+	uint32_t primes[size];
+	uint64_t inverses[size];  // primes[i]^-1 mod 2^64 (2^63 for 2): n * inverses[i] is n / primes[i] when it divides (odd primes)
+	uint64_t limits[size];  // (2^64 - 1) / primes[i] (0 for 2)
+
+	constexpr PrimeTable () : primes(), inverses(), limits()
+	{
+		int k = 0;
+		for (uint64_t n = 2; n < Bound; ++n) {
+			if (StaticPrimes::isPrime(n)) {
+				primes[k] = uint32_t (n);
+				inverses[k] = n == 2 ? uint64_t (1) << 63 : StaticPrimes::inverse(n);
+				limits[k] = n == 2 ? 0 : UINT64_MAX / n;
+				k++;
+			}
+		}
+	}
+
+	// Multiplying by the inverse maps the multiples of p onto [0, limit] and everything else above it
+	constexpr bool divides (const int i, const uint64_t n) const { return n * inverses[i] <= limits[i]; }
+};
+
+template <int M>
+struct Wheel  // The residues mod M coprime to M, in order, and the residue -> position table
+{
+	static constexpr int size = StaticPrimes::totient(M);
+
+	int residues[size];
+	int16_t index[M];  // Position of each residue in residues, -1 if it shares a factor with M
+
+	constexpr Wheel () : residues(), index()
+	{
+		int k = 0;
+		for (int r = 0; r < M; ++r) {
+			index[r] = -1;
+			if (StaticPrimes::gcd(uint64_t (r), uint64_t (M)) == 1) {
+				residues[k] = r;
+				index[r] = int16_t (k++);
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include <algorithm>  // func: std::min()
+#include <cstddef>  // Type: size_t
+#include <cstdint>  // Type: uint8_t, int64_t, uint64_t, Macro: SIZE_MAX
+#include <utility>  // Type: std::pair
+#include <vector>  // Type: std::vector
+
+#include "libprimes.h"
+#include "Parallel.h"
+#include "Primes.h"
+
+using namespace std;
+
+static const long batchChunk = 256;  // Values per pool task
+
+// No exception may unwind into the C caller (through a ctypes/cffi frame that terminates the process), so every entry
+// point that reaches the library catches everything and returns its error value instead (see libprimes.h)
+
+static size_t factorizeInto (const uint64_t n, uint64_t* primes, uint8_t* exponents)
+{
+	static thread_local vector<pair<uint64_t, int> > powers;  // Reused by every call on this thread
+	Primes::primeFactorization(n, powers);
+	for (size_t i = 0; i < powers.size(); ++i) {
+		primes[i] = powers[i].first;
+		exponents[i] = uint8_t (powers[i].second);
+	}
+	return powers.size();
+}
+
+int primes_abi_version (void)
+{
+	return PRIMES_ABI_VERSION;
+}
+
+const char* primes_batch_kernel (void)
+{
+	try {
+		return Primes::batchKernelName();
+	}
+	catch (...) {
+		return nullptr;
+	}
+}
+
+int primes_use_cache (const char* path)
+{
+	try {
+		return path != nullptr && Primes::useCache(path);
+	}
+	catch (...) {
+		return 0;
+	}
+}
+
+int primes_use_factor_table (uint32_t bound, int odd_only)
+{
+	try {
+		Primes::useFactorTable(bound, odd_only != 0);
+		return 0;
+	}
+	catch (...) {
+		return -1;
+	}
+}
+
+int primes_is_prime (uint64_t n)
+{
+	try {
+		if (n > 0 && n <= uint64_t (INT64_MAX)) {
+			return Primes::isPrimeEfficient(long (n));  // The cache, when it covers n
+		}
+		return Primes::isPrime64(n);
+	}
+	catch (...) {
+		return -1;
+	}
+}
+
+int64_t primes_pi (int64_t n, int threads)
+{
+	try {
+		return Primes::piEfficient(long (n), threads);
+	}
+	catch (...) {
+		return -1;
+	}
+}
+
+int64_t primes_pi_sublinear (int64_t n)
+{
+	try {
+		return Primes::piSublinear(long (n));
+	}
+	catch (...) {
+		return -1;
+	}
+}
+
+size_t primes_factorize (uint64_t n, uint64_t* primes, uint8_t* exponents)
+{
+	try {
+		return factorizeInto(n, primes, exponents);
+	}
+	catch (...) {
+		return SIZE_MAX;
+	}
+}
+
+size_t primes_list (int64_t lo, int64_t hi, int64_t* out, size_t capacity)
+{
+	try {
+		size_t total = 0;
+		Primes::forEachPrime(long (lo), long (hi), [&](long p) {
+			if (total < capacity) out[total] = p;
+			total++;
+		});
+		return total;
+	}
+	catch (...) {
+		return SIZE_MAX;
+	}
+}
+
+int primes_is_prime_batch (const uint64_t* values, size_t count, uint8_t* out)
+{
+	try {
+		Primes::isPrimeBatch(values, count, out);
+		return 0;
+	}
+	catch (...) {
+		return -1;
+	}
+}
+
+int primes_pi_batch (const int64_t* values, size_t count, int64_t* out, int threads)
+{
+	try {
+		// One sieve per value is already parallel inside, so the values themselves are answered in order
+		for (size_t i = 0; i < count; ++i) {
+			out[i] = Primes::piEfficient(long (values[i]), threads);
+		}
+		return 0;
+	}
+	catch (...) {
+		return -1;
+	}
+}
+
+int primes_factorize_batch (const uint64_t* values, size_t count, uint64_t* primes, uint8_t* exponents, uint8_t* counts, int threads)
+{
+	try {
+		const long tasks = long ((count + batchChunk - 1) / batchChunk);
+		Parallel::forRange(tasks, Parallel::threadCount(threads), [&](long t, int) {  // Rethrows here what a worker throws
+			const size_t end = min(count, size_t (t + 1) * batchChunk);
+			for (size_t i = size_t (t) * batchChunk; i < end; ++i) {
+				counts[i] = uint8_t (factorizeInto(values[i], primes + i * PRIMES_MAX_FACTORS, exponents + i * PRIMES_MAX_FACTORS));
+			}
+		});
+		return 0;
+	}
+	catch (...) {
+		return -1;
+	}
+}
@@ -0,0 +1,45 @@
+#ifndef LIBPRIMES_H
+#define LIBPRIMES_H
+
+/* C interface to Primes, built as libprimes.so (see README).
+ * Plain integers and caller-owned arrays only: a numpy array's data pointer can be passed straight through
+ * ctypes/cffi, nothing is copied or converted per element, and no C++ type crosses the boundary.
+ * No exception crosses it either: a call that fails (out of memory, no threads) returns the error value noted
+ * beside it, and its output arrays are then incomplete. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PRIMES_ABI_VERSION 1  /* Bumped on any incompatible change to the functions below */
+#define PRIMES_MAX_FACTORS 15  /* Distinct prime factors of a 64-bit number: 2*3*5*...*53 already exceeds 2^64 */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PRIMES_API __attribute__((visibility("default")))
+
+PRIMES_API int primes_abi_version (void);
+PRIMES_API const char* primes_batch_kernel (void);  /* "avx512", "avx2" or "scalar"; NULL on error */
+
+/* Configuration: call before querying from several threads */
+PRIMES_API int primes_use_cache (const char* path);  /* 1 if the cache was mapped, 0 if not or on error */
+PRIMES_API int primes_use_factor_table (uint32_t bound, int odd_only);  /* 0 drops the table. Returns 0, or -1 on error */
+
+/* Single queries. threads <= 0 uses every core */
+PRIMES_API int primes_is_prime (uint64_t n);  /* 1 or 0; -1 on error */
+PRIMES_API int64_t primes_pi (int64_t n, int threads);  /* Segmented sieve (or the cache); -1 on error */
+PRIMES_API int64_t primes_pi_sublinear (int64_t n);  /* -1 on error */
+PRIMES_API size_t primes_factorize (uint64_t n, uint64_t* primes, uint8_t* exponents);  /* Fills PRIMES_MAX_FACTORS slots at most, returns the count (0 for n < 2); SIZE_MAX on error */
+PRIMES_API size_t primes_list (int64_t lo, int64_t hi, int64_t* out, size_t capacity);  /* Primes of [lo, hi]: writes up to capacity, returns the total; SIZE_MAX on error */
+
+/* Batches: one output per input. Each returns 0, or -1 on error */
+PRIMES_API int primes_is_prime_batch (const uint64_t* values, size_t count, uint8_t* out);  /* On the calling thread, SIMD lanes where available (see primes_batch_kernel) */
+PRIMES_API int primes_pi_batch (const int64_t* values, size_t count, int64_t* out, int threads);  /* Values one after another, each sieve spread over threads */
+PRIMES_API int primes_factorize_batch (const uint64_t* values, size_t count, uint64_t* primes, uint8_t* exponents, uint8_t* counts, int threads);  /* Chunks of values spread over threads; PRIMES_MAX_FACTORS slots per value */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
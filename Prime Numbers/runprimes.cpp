@@ -1,78 +1,433 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include "Parallel.h"
+#include "PiIndex.h"
+#include "PrimeShard.h"
+#include "PrimeStats.h"
+#include "PrimeCache.h"
 #include "Primes.h"
 #include <list>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
 
-const char *help = "Prime Calculator. Functions:\n"
+const char *help = "Prime Calculator. Functions:  (runprimes [--stats] function args; --stats needs -DPRIMES_STATS)\n"
 	"  prime -- isPrime(long)\n"
 	" primef -- isPrimeEfficient(long)\n"
 	"     pi -- pi(long)\n"
-	"    pif -- piEfficient(long)\n"
+	"    pif -- piEfficient(long, [threads])  (threads: 0 = all cores)\n"
+	"    pis -- piSublinear(long)\n"
 	" factor -- primeFactorize(long)\n"
-	"decomps -- primeDecompose(long)";
+	"decomps -- primeDecompose(long)\n"
+	"          (prime, primef, factor and decomps also take numbers up to 2^128 - 1)\n"
+	"  count -- primeCount(lo, hi), primes in [lo, hi]\n"
+	"    nth -- nthPrime(k), nth 1 = 2\n"
+	" stream -- read one command per line from stdin, one result per line to stdout: stream [threads]\n"
+	"  range -- every prime in [lo, hi], one per line: range lo hi\n"
+	"  shard -- count the primes of [lo, hi] into a partial-result file, resuming it if interrupted: shard lo hi path [threads]\n"
+	"  merge -- combine complete shards that tile one range, printed as a shard file: merge path [path ...]\n"
+	"  cache -- build or extend the prime bitmap cache: cache path bound [threads]\n"
+	"          (set PRIMES_CACHE=path to use it for primef and pif)\n"
+	"  index -- build or extend the pi(x) checkpoint index: index path bound [threads]\n"
+	"          (set PRIMES_PI_INDEX=path to use it for count and nth)\n"
+	"          (set PRIMES_FACTOR_TABLE=bound to factor every n <= bound by table lookups)";
 
 constexpr unsigned int str2int(const char* str, int h = 0)
 {
     return !str[h] ? 5381 : (str2int(str, h+1) * 33) ^ str[h];
 }
 
-int main(int argc, char** argv)
+static bool parseLong (const char* str, long& value)  // No allocation, unlike stol
 {
-	if (argc <= 1) {  // ((argv[1] != NULL) && (argv[1][0] == '\0'))
-		cout << "Invalid option, try \"help\" instead?" << endl;
-		return 0;
+	if (str == nullptr) return false;
+	char* end;
+	errno = 0;
+	value = strtol(str, &end, 10);
+	return end != str && *end == '\0' && errno == 0;
+}
+
+static void appendNumber (string& out, uint64_t value)
+{
+	char digits[20];
+	int n = 0;
+	do {
+		digits[n++] = char ('0' + value % 10);
+		value /= 10;
+	} while (value);
+	while (n) out += digits[--n];
+}
+
+static bool parseU128 (const char* str, unsigned __int128& value)  // Decimal, up to 2^128 - 1
+{
+	if (str == nullptr || *str == '\0') return false;
+	const unsigned __int128 max = ~(unsigned __int128) 0;
+	value = 0;
+	for (; *str; ++str) {
+		if (*str < '0' || *str > '9') return false;
+		const unsigned digit = unsigned (*str - '0');
+		if (value > (max - digit) / 10) return false;
+		value = value * 10 + digit;
 	}
-	if (!strcmp (argv[1], "help")) {
-		cout << help << endl;
-		return 0;
+	return true;
+}
+
+static void appendNumber128 (string& out, unsigned __int128 value)
+{
+	char digits[40];
+	int n = 0;
+	do {
+		digits[n++] = char ('0' + unsigned (value % 10));
+		value /= 10;
+	} while (value);
+	while (n) out += digits[--n];
+}
+
+// Commands that accept numbers past the range of long
+static bool answer128 (const char* cmd, const unsigned __int128 n, string& out)
+{
+	static thread_local vector<pair<unsigned __int128, int> > powers;
+	switch (str2int(cmd)) {
+		case str2int("prime"):
+		case str2int("primef"): {
+			out += Primes::isPrime128(n) ? '1' : '0';
+			break;
+		}
+		case str2int("decomps"): {
+			Primes::primeFactorization128(n, powers);
+			for (size_t i = 0; i < powers.size(); ++i) {
+				if (i) out += ' ';
+				appendNumber128(out, powers[i].first);
+				if (powers[i].second > 1) {
+					out += '^';
+					appendNumber(out, uint64_t (powers[i].second));
+				}
+			}
+			break;
+		}
+		case str2int("factor"): {
+			Primes::primeFactorization128(n, powers);
+			for (size_t i = 0; i < powers.size(); ++i) {
+				appendNumber128(out, powers[i].first);
+				out += ' ';
+			}
+			break;
+		}
+		default: {
+			return false;
+		}
 	}
-	if (argc < 3) {
-		cout << "ERROR Not enough arguments.\ntry \"help\" instead?" << endl;
-		return 1;
+	return true;
+}
+
+// Appends the answer to one command to out (without a newline). Returns false for unknown commands or bad arguments.
+static bool answer (const char* cmd, const char* arg, const char* arg2, string& out)
+{
+	static thread_local vector<pair<uint64_t, int> > powers;  // Reused by every factoring query on this thread
+	long n, k;
+	if (!parseLong(arg, n)) {
+		unsigned __int128 big;
+		return parseU128(arg, big) && answer128(cmd, big, out);
 	}
-	switch (str2int(argv[1])) {
+	switch (str2int(cmd)) {
 		case str2int("prime"): {
-			cout << Primes::isPrime(stol (argv[2],nullptr,10)) << endl;
+			if (n <= 0) return false;
+			out += Primes::isPrime(n) ? '1' : '0';
 			break;
 		}
 		case str2int("primef"): {
-			cout << Primes::isPrimeEfficient(stol (argv[2],nullptr,10)) << endl;
+			if (n <= 0) return false;
+			out += Primes::isPrimeEfficient(n) ? '1' : '0';
 			break;
 		}
 		case str2int("pi"): {
-			cout << Primes::pi(stol (argv[2],nullptr,10)) << endl;
+			appendNumber(out, Primes::pi(n));
 			break;
 		}
 		case str2int("pif"): {
-			cout << Primes::piEfficient(stol (argv[2],nullptr,10)) << endl;
+			if (!parseLong(arg2, k)) k = 1;
+			appendNumber(out, Primes::piEfficient(n, int (k)));
+			break;
+		}
+		case str2int("pis"): {
+			appendNumber(out, Primes::piSublinear(n));
+			break;
+		}
+		case str2int("count"): {
+			if (!parseLong(arg2, k)) return false;
+			appendNumber(out, Primes::primeCount(n, k));
+			break;
+		}
+		case str2int("nth"): {
+			if (n <= 0) return false;
+			appendNumber(out, Primes::nthPrime(n));
 			break;
 		}
 		case str2int("decomps"): {
-			cout << Primes::primeDecompose(stol (argv[2],nullptr,10)) << endl;
+			if (n <= 0) return false;
+			Primes::primeFactorization(uint64_t (n), powers);
+			if (powers.empty()) out += "ERROR";
+			for (size_t i = 0; i < powers.size(); ++i) {
+				if (i) out += ' ';
+				appendNumber(out, powers[i].first);
+				if (powers[i].second > 1) {
+					out += '^';
+					appendNumber(out, uint64_t (powers[i].second));
+				}
+			}
 			break;
 		}
 		case str2int("factor"): {
-			const list<long> factors = Primes::primeFactorize(stol (argv[2],nullptr,10));
-			for (list<long>::const_iterator i = factors.begin(); i != factors.end(); ++i) {
-				cout << *i << " ";
+			if (n <= 0) return false;
+			Primes::primeFactorization(uint64_t (n), powers);
+			for (size_t i = 0; i < powers.size(); ++i) {
+				appendNumber(out, powers[i].first);
+				out += ' ';
 			}
-			cout << endl;
 			break;
 		}
 		case str2int("fermat"): {
-			cout << Primes::fermat(stol (argv[2],nullptr,10), stoi (argv[3],nullptr,10)) << endl;
+			if (n <= 0) return false;
+			if (!parseLong(arg2, k)) k = 5;
+			out += Primes::fermat(n, int (k)) ? '1' : '0';
 			break;
 		}
 		case str2int("miller"): {
-			cout << Primes::miller(stol (argv[2],nullptr,10), stoi (argv[3],nullptr,10)) << endl;
+			if (n <= 0) return false;
+			if (!parseLong(arg2, k)) k = 5;
+			out += Primes::miller(n, int (k)) ? '1' : '0';
 			break;
 		}
 		default: {
-			cout << "ERROR: option not found" << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+// Splits a line in place into at most three whitespace separated tokens and answers it
+static void answerLine (char* line, string& out)
+{
+	char* tokens[3] = {nullptr, nullptr, nullptr};
+	int count = 0;
+	for (char* c = line; *c; ) {
+		while (*c == ' ' || *c == '\t' || *c == '\r') *c++ = '\0';
+		if (!*c) break;
+		if (count == 3) {
+			count = 4;  // Too many arguments
+			break;
+		}
+		tokens[count++] = c;
+		while (*c && *c != ' ' && *c != '\t' && *c != '\r') ++c;
+	}
+	const size_t mark = out.size();
+	if (count < 2 || count > 3 || !answer(tokens[0], tokens[1], tokens[2], out)) {
+		out.resize(mark);
+		out += "ERROR";
+	}
+	out += '\n';
+}
+
+static bool writeAll (const string& out)
+{
+	size_t done = 0;
+	while (done < out.size()) {
+		ssize_t n = write(1, out.data() + done, out.size() - done);
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) return false;
+		done += size_t (n);
+	}
+	return true;
+}
+
+// Streaming mode: answers every complete line available on stdin, then writes all the results in input order.
+// Buffers (input, line list, per-line results) are reused, so steady state does no per-line allocation.
+static int stream (const int threads)
+{
+	const int workers = Parallel::threadCount(threads);
+	const long chunk = 16;  // Lines per pool task
+	vector<char> in(1 << 20);
+	vector<char*> lines;
+	vector<string> results(workers > 1 ? 1 : 0);
+	string out;
+	size_t filled = 0;
+
+	for (bool eof = false; !eof; ) {
+		ssize_t got = read(0, in.data() + filled, in.size() - filled);
+		if (got < 0 && errno == EINTR) continue;
+		eof = got <= 0;
+		filled += eof ? 0 : size_t (got);
+
+		if (eof && filled == in.size()) in.push_back('\0');  // Room to terminate an unfinished last line
+
+		lines.clear();
+		size_t start = 0;
+		for (size_t i = 0; i < filled; ++i) {
+			if (in[i] == '\n') {
+				in[i] = '\0';
+				lines.push_back(&in[start]);
+				start = i + 1;
+			}
+		}
+		if (eof && start < filled) {
+			in[filled] = '\0';
+			lines.push_back(&in[start]);
+			start = filled;
+		}
+
+		out.clear();
+		if (workers > 1 && lines.size() > 1) {
+			const long tasks = (long (lines.size()) + chunk - 1) / chunk;
+			if (results.size() < size_t (tasks)) results.resize(tasks);
+			Parallel::forRange(tasks, workers, [&](long t, int) {
+				results[t].clear();
+				for (long i = t * chunk; i < min(long (lines.size()), (t + 1) * chunk); ++i) {
+					answerLine(lines[i], results[t]);
+				}
+			});
+			for (long t = 0; t < tasks; ++t) out += results[t];
+		} else {
+			for (size_t i = 0; i < lines.size(); ++i) {
+				answerLine(lines[i], out);
+			}
+		}
+		if (!writeAll(out)) return 1;
+
+		// Keep the incomplete last line; grow only if a single line fills the whole buffer
+		filled -= start;
+		memmove(in.data(), in.data() + start, filled);
+		if (filled == in.size()) in.resize(in.size() * 2);
+	}
+	return 0;
+}
+
+static int run (int argc, char** argv)
+{
+	if (argc <= 1) {  // ((argv[1] != NULL) && (argv[1][0] == '\0'))
+		cout << "Invalid option, try \"help\" instead?" << endl;
+		return 0;
+	}
+	if (!strcmp (argv[1], "help")) {
+		cout << help << endl;
+		return 0;
+	}
+	const char* cachePath = getenv("PRIMES_CACHE");
+	if (cachePath != nullptr && *cachePath && !Primes::useCache(cachePath)) {
+		cerr << "WARNING: could not open prime cache " << cachePath << endl;
+	}
+	const char* indexPath = getenv("PRIMES_PI_INDEX");
+	if (indexPath != nullptr && *indexPath && !Primes::usePiIndex(indexPath)) {
+		cerr << "WARNING: could not open pi index " << indexPath << endl;
+	}
+	const char* tableBound = getenv("PRIMES_FACTOR_TABLE");
+	long bound;
+	if (tableBound != nullptr && parseLong(tableBound, bound) && bound > 0 && bound <= 0xFFFFFFFFL) {
+		Primes::useFactorTable(uint32_t (bound), true);
+	}
+	if (!strcmp (argv[1], "cache")) {
+		long threads;
+		if (argc < 4 || !parseLong(argv[3], bound) || bound < 0) {
+			cout << "ERROR Usage: cache path bound [threads]" << endl;
+			return 1;
+		}
+		const bool built = PrimeCache::build(argv[2], uint64_t (bound), argc > 4 && parseLong(argv[4], threads) ? int (threads) : 1);
+		cout << (built ? "1" : "ERROR") << endl;
+		return built ? 0 : 1;
+	}
+	if (!strcmp (argv[1], "index")) {
+		long threads;
+		if (argc < 4 || !parseLong(argv[3], bound) || bound < 0) {
+			cout << "ERROR Usage: index path bound [threads]" << endl;
 			return 1;
 		}
+		const bool built = PiIndex::build(argv[2], uint64_t (bound), argc > 4 && parseLong(argv[4], threads) ? int (threads) : 1);
+		cout << (built ? "1" : "ERROR") << endl;
+		return built ? 0 : 1;
 	}
+	if (!strcmp (argv[1], "shard")) {
+		long lo, hi, threads;
+		if (argc < 5 || !parseLong(argv[2], lo) || !parseLong(argv[3], hi) || lo < 0 || hi < lo) {
+			cout << "ERROR Usage: shard lo hi path [threads]" << endl;
+			return 1;
+		}
+		ShardRecord r;
+		if (!PrimeShard::run(argv[4], lo, hi, argc > 5 && parseLong(argv[5], threads) ? int (threads) : 1, r)) {
+			cout << "ERROR: could not run shard " << argv[4] << " (unwritable, or it holds a different range)" << endl;
+			return 1;
+		}
+		cout << r.count << endl;
+		return 0;
+	}
+	if (!strcmp (argv[1], "merge")) {
+		vector<ShardRecord> shards(argc > 2 ? argc - 2 : 0);
+		for (int i = 2; i < argc; ++i) {
+			if (!PrimeShard::load(argv[i], shards[i - 2])) {
+				cout << "ERROR: could not read shard " << argv[i] << endl;
+				return 1;
+			}
+		}
+		ShardRecord total;
+		string error;
+		if (!PrimeShard::merge(shards, total, error)) {
+			cout << "ERROR: " << error << endl;
+			return 1;
+		}
+		cout << PrimeShard::text(total);
+		return 0;
+	}
+	if (!strcmp (argv[1], "range")) {
+		long lo, hi;
+		if (argc < 4 || !parseLong(argv[2], lo) || !parseLong(argv[3], hi)) {
+			cout << "ERROR Usage: range lo hi" << endl;
+			return 1;
+		}
+		// Streamed straight from the sieve and flushed in 64 KiB pieces, never held in memory
+		string out;
+		bool ok = true;
+		Primes::forEachPrime(lo, hi, [&](long p) {
+			appendNumber(out, uint64_t (p));
+			out += '\n';
+			if (out.size() >= (1 << 16)) {
+				ok = ok && writeAll(out);
+				out.clear();
+			}
+		});
+		return ok && writeAll(out) ? 0 : 1;
+	}
+	if (!strcmp (argv[1], "stream")) {
+		long threads;
+		return stream(argc > 2 && parseLong(argv[2], threads) ? int (threads) : 1);
+	}
+	if (argc < 3) {
+		cout << "ERROR Not enough arguments.\ntry \"help\" instead?" << endl;
+		return 1;
+	}
+	string out;
+	if (!answer(argv[1], argv[2], argc > 3 ? argv[3] : nullptr, out)) {
+		cout << "ERROR: option not found" << endl;
+		return 1;
+	}
+	cout << out << endl;
 	return 0;
 }
+
+int main(int argc, char** argv)
+{
+	// --stats (first) dumps the per-stage counters to stderr once the command or batch is done
+	const bool stats = argc > 1 && !strcmp (argv[1], "--stats");
+	if (stats) {
+		argv[1] = argv[0];
+		argv++;
+		argc--;
+	}
+	const int status = run(argc, argv);
+	if (stats) {
+		cerr << PrimeStats::report();
+	}
+	return status;
+}